@@ -0,0 +1,582 @@
+﻿/**
+*
+* \file
+*
+* \brief Кэширование записей и снимков данных сценариев эмуляционного моделирования и применение пакетов уведомлений БД к моделям
+*
+*/
+#pragma once
+
+#include "emulation_widgets.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <odb/connection.hxx>
+#include <odb/session.hxx>
+#include <odb/transaction.hxx>
+
+namespace Emulation
+{
+
+	/**
+	*
+	* \brief Статистика выполнения подготовленных запросов одного типа
+	*
+	* Счетчики атомарны, поэтому статистика пополняется также из рабочих потоков загрузки.
+	*
+	*/
+	class QueryStatistics
+	{
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param name - наименование запроса, используемое в отчете
+		*
+		*/
+		QueryStatistics(const QString &name);
+
+		/// Функция возвращает наименование запроса
+		QString name() const;
+
+		/// Функция возвращает общее количество выполнений запроса
+		qint64 callsCount() const;
+
+		/// Функция возвращает количество подготовок запроса (по одной на каждое соединение)
+		qint64 preparedCount() const;
+
+		/// Функция возвращает количество выполнений с повторным использованием подготовленного запроса
+		qint64 reusedCount() const;
+
+		/// Функция возвращает суммарное время выполнения запроса в наносекундах
+		qint64 totalTime() const;
+
+		/// Функция возвращает среднее время выполнения запроса в микросекундах
+		double averageTime() const;
+
+		/**
+		*
+		* \brief Функция служит для учета одного выполнения запроса
+		*
+		* \param reused - признак использования ранее подготовленного запроса
+		* \param nsecs - время выполнения в наносекундах
+		*
+		*/
+		void addCall(const bool reused, const qint64 nsecs);
+
+		/// Функция служит для сброса счетчиков
+		void reset();
+
+		/// Функция возвращает статистику всех зарегистрированных запросов
+		static QList<QueryStatistics *> all();
+
+		/// Функция возвращает текстовый отчет по всем зарегистрированным запросам
+		static QString report();
+
+	private:
+		static QList<QueryStatistics *> &registry();
+		static QMutex &registryMutex();
+
+		QString m_name; ///< Наименование запроса
+
+		QAtomicInteger<qint64> m_callsCount; ///< Количество выполнений
+		QAtomicInteger<qint64> m_preparedCount; ///< Количество подготовок
+		QAtomicInteger<qint64> m_totalTime; ///< Суммарное время выполнения в наносекундах
+	};
+
+	/**
+	*
+	* \brief Класс, служащий для чтения одной записи по индексу БД подготовленным запросом
+	*
+	* Запрос подготавливается один раз для каждого соединения и типа записи и сохраняется в кэше запросов
+	* соединения ODB, последующие обращения только подставляют значение параметра. Используется вместо
+	* Store::query_one_by_id в обработчиках уведомлений и при обновлении моделей.
+	*
+	*/
+	template<class Store>
+	class QueryByIdCache
+	{
+	public:
+		typedef typename Store::value_type RecordPtr;
+		typedef typename RecordPtr::element_type Record;
+
+		/**
+		*
+		* \brief Функция возвращает запись с заданным индексом или пустой указатель при ее отсутствии
+		*
+		* Выполняется в текущей транзакции потока, а при ее отсутствии - в собственной. Ошибка БД в текущей
+		* транзакции передается вызывающему, в собственной - возвращается как пустой указатель.
+		*
+		* \param id - индекс БД
+		*
+		*/
+		static RecordPtr fetch(const long id)
+		{
+			QElapsedTimer timer;
+			timer.start();
+
+			RecordPtr result;
+			bool reused = false;
+
+			// Ошибка в транзакции вызывающего передается ему, иначе транзакция продолжилась бы после сбоя
+			if (odb::transaction::has_current())
+				result = execute(odb::transaction::current().connection(), id, reused);
+			else {
+				try {
+					odb::transaction transaction(emulation_dal::DB::database()->begin());
+
+					result = execute(transaction.connection(), id, reused);
+
+					transaction.commit();
+				}
+				catch (const odb::exception &) {
+					result.reset();
+				}
+			}
+
+			statistics().addCall(reused, timer.nsecsElapsed());
+
+			return result;
+		}
+
+		/// Функция возвращает статистику выполнения запроса
+		static QueryStatistics &statistics()
+		{
+			static QueryStatistics value(QString("query_one_by_id<%1>").arg(typeid(Record).name()));
+
+			return value;
+		}
+
+	private:
+		static RecordPtr execute(odb::connection &connection, const long id, bool &reused)
+		{
+			typedef odb::query<Record> query;
+
+			// Наименование запроса должно иметь статическое время жизни
+			const char *name = typeid(Record).name();
+
+			long *params = nullptr;
+			odb::prepared_query<Record> preparedQuery = connection.lookup_query<Record>(name, params);
+
+			reused = preparedQuery ? true : false;
+
+			if (!reused) {
+				std::unique_ptr<long> newParams(new long(0));
+				params = newParams.get();
+
+				preparedQuery = connection.prepare_query<Record>(name, query::id == query::_ref(*params));
+				connection.cache_query(preparedQuery, std::move(newParams));
+			}
+
+			*params = id;
+
+			return preparedQuery.execute_one();
+		}
+	};
+
+	/**
+	*
+	* \brief Разделяемый кэш записей, полученных при обработке уведомлений БД
+	*
+	* Запись, прочитанная из БД одним из получателей уведомления (например, для проверки принадлежности сценарию),
+	* помещается в кэш и используется остальными получателями и моделями без повторного обращения к БД.
+	* Уведомления об изменении и удалении записи исключают ее из кэша.
+	*
+	*/
+	template<class Store>
+	class NotifyRecordCache
+	{
+	public:
+		typedef typename Store::value_type RecordPtr;
+
+		/// Функция возвращает признак использования кэша
+		static bool isEnabled()
+		{
+			return enabledFlag();
+		}
+
+		/**
+		*
+		* \brief Функция служит для включения и отключения кэша
+		*
+		* \param value - признак использования кэша
+		*
+		*/
+		static void setEnabled(const bool value)
+		{
+			enabledFlag() = value;
+
+			if (!value)
+				cache().clear();
+		}
+
+		/**
+		*
+		* \brief Функция помещает запись в кэш
+		*
+		* \param value - запись, полученная из БД
+		*
+		*/
+		static void insert(const RecordPtr &value)
+		{
+			if (value && isEnabled())
+				cache().insert(value->id(), new RecordPtr(value));
+		}
+
+		/**
+		*
+		* \brief Функция исключает запись из кэша
+		*
+		* \param id - индекс БД
+		*
+		*/
+		static void remove(const long id)
+		{
+			cache().remove(id);
+		}
+
+		/**
+		*
+		* \brief Функция возвращает запись с заданным индексом, обращаясь к БД только при ее отсутствии в кэше
+		*
+		* \param id - индекс БД
+		*
+		*/
+		static RecordPtr fetch(const long id)
+		{
+			if (isEnabled()) {
+				auto cached = cache().object(id);
+
+				if (cached)
+					return *cached;
+			}
+
+			auto result = QueryByIdCache<Store>::fetch(id);
+
+			insert(result);
+
+			return result;
+		}
+
+	private:
+		static bool &enabledFlag()
+		{
+			static bool flag = true;
+
+			return flag;
+		}
+
+		static QCache<long, RecordPtr> &cache()
+		{
+			static QCache<long, RecordPtr> records(4096);
+
+			return records;
+		}
+	};
+
+	/**
+	*
+	* \brief Сессия ODB (карта идентичности), принадлежащая открытому окну сценария
+	*
+	* Объекты, загруженные в области действия сессии, в том числе по ленивым указателям (evt(), eft(), eht(), etc(),
+	* emulation(), eg(), es()), создаются один раз и разделяются всеми моделями и виджетами окна. Уведомления
+	* об изменении и удалении записей исключают их из сессии. Сессия удаляется вместе с окном.
+	*
+	* Окна редактирования загружают записи вне сессии, чтобы изменения в диалогах не попадали в общие объекты.
+	*
+	*/
+	class EmulationSession : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Класс, делающий сессию текущей для потока на время своего существования
+		*
+		*/
+		class Scope
+		{
+		public:
+			/**
+			*
+			* \brief Конструктор
+			*
+			* \param object - объект окна сценария или любой из его дочерних объектов
+			*
+			*/
+			Scope(const QObject *object);
+
+			/// Деструктор, восстанавливающий прежнюю текущую сессию
+			~Scope();
+
+		private:
+			Q_DISABLE_COPY(Scope)
+
+			odb::session *m_previous; ///< Сессия, бывшая текущей до создания области
+			bool m_active; ///< Признак установки сессии окна текущей
+		};
+
+		/**
+		*
+		* \brief Функция создает сессию окна сценария, если она еще не создана
+		*
+		* \param container - окно сценария (ViewWidget, EditWidget)
+		*
+		*/
+		static EmulationSession *attach(QObject *container);
+
+		/**
+		*
+		* \brief Функция возвращает сессию окна, которому принадлежит объект, или nullptr
+		*
+		* \param object - объект окна сценария или любой из его дочерних объектов
+		*
+		*/
+		static EmulationSession *of(const QObject *object);
+
+		/// Функция возвращает сессию ODB
+		odb::session &session();
+
+		/// Функция служит для исключения из сессии всех объектов
+		void clear();
+
+		/// Деструктор
+		~EmulationSession();
+
+	private slots:
+		void eraseEmulation(const NotifyEvent &ev);
+		void eraseVariable(const NotifyEvent &ev);
+		void eraseFile(const NotifyEvent &ev);
+		void eraseRuntimeRequest(const NotifyEvent &ev);
+		void eraseTopologyHost(const NotifyEvent &ev);
+
+	private:
+		/// Конструктор
+		EmulationSession(QObject *container);
+
+		/// Функция для создания сигнально-слотовых соединений с уведомлениями БД
+		void createUpdateConnections();
+
+		/// Функция исключает из сессии объект заданного типа с заданным индексом
+		template<class Record>
+		void erase(const long id)
+		{
+			m_session->cache_erase<Record>(*emulation_dal::DB::database(), id);
+		}
+
+		std::unique_ptr<odb::session> m_session; ///< Сессия ODB
+	};
+
+	/**
+	*
+	* \brief Класс, служащий для применения пакета уведомлений к модели на основе DBTableModel
+	*
+	* Удаленные и добавленные записи обрабатываются непрерывными диапазонами строк, измененные - одним сигналом
+	* dataChanged на каждый непрерывный диапазон. Модель должна объявить класс дружественным и предоставлять
+	* функции rowById и containsId.
+	*
+	*/
+	template<class Store>
+	class NotifyBatchApplier
+	{
+	public:
+		/**
+		*
+		* \brief Функция служит для применения пакета уведомлений к модели
+		*
+		* \param model - модель, к которой применяется пакет
+		* \param batch - пакет уведомлений
+		* \param prepend - признак добавления новых записей в начало модели (от новых к старым)
+		*
+		*/
+		template<class Model>
+		static void apply(Model *model, const NotifyEventBatch &batch, const bool prepend = false)
+		{
+			if (!model || batch.isEmpty())
+				return;
+
+			removeRows(model, batch.removed);
+			updateRows(model, batch.updated);
+			appendRows(model, batch.added, prepend);
+		}
+
+		/**
+		*
+		* \brief Функция служит для вставки записей в модель одним диапазоном строк, начиная с заданной строки
+		*
+		* Записи, уже присутствующие в модели, пропускаются.
+		*
+		* \param model - модель, в которую добавляются записи
+		* \param row - номер строки, перед которой вставляются записи
+		* \param records - добавляемые записи
+		*
+		*/
+		template<class Model>
+		static void insertRecords(Model *model, const int row, Store records)
+		{
+			records.erase(std::remove_if(records.begin(), records.end(), [model](const typename Store::value_type &record) {
+				return !record || model->containsId(record->id());
+			}), records.end());
+
+			if (!records.empty()) {
+				model->beginInsertRows(QModelIndex(), row, row + static_cast<int>(records.size()) - 1);
+				model->Store::insert(model->Store::begin() + row, std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+				model->endInsertRows();
+			}
+		}
+
+		/// Функция служит для добавления записей в конец модели одним диапазоном строк
+		template<class Model>
+		static void appendRecords(Model *model, Store records)
+		{
+			insertRecords(model, model->size(), std::move(records));
+		}
+
+	private:
+		template<class Model, class Container>
+		static QList<QPair<int, int>> ranges(const Model *model, const Container &ids)
+		{
+			QList<int> sortedRows;
+
+			for (auto id : ids) {
+				int row = model->rowById(id);
+
+				if (row >= 0)
+					sortedRows << row;
+			}
+
+			std::sort(sortedRows.begin(), sortedRows.end());
+
+			QList<QPair<int, int>> result;
+
+			for (auto row : sortedRows) {
+				if (!result.isEmpty() && result.last().second + 1 == row)
+					result.last().second = row;
+				else
+					result << qMakePair(row, row);
+			}
+
+			return result;
+		}
+
+		template<class Model>
+		static void removeRows(Model *model, const QSet<long> &ids)
+		{
+			if (ids.isEmpty())
+				return;
+
+			auto spans = ranges(model, ids);
+
+			// Диапазоны удаляются с конца, чтобы не пересчитывать номера строк
+			for (int i = spans.size() - 1; i >= 0; --i) {
+				model->beginRemoveRows(QModelIndex(), spans[i].first, spans[i].second);
+				model->Store::erase(model->Store::begin() + spans[i].first, model->Store::begin() + spans[i].second + 1);
+				model->endRemoveRows();
+			}
+		}
+
+		template<class Model>
+		static void updateRows(Model *model, const QSet<long> &ids)
+		{
+			if (ids.isEmpty())
+				return;
+
+			QSet<long> updatedIds;
+
+			for (auto id : ids) {
+				int row = model->rowById(id);
+
+				if (row >= 0) {
+					auto record = NotifyRecordCache<Store>::fetch(id);
+
+					if (record) {
+						*(model->Store::begin() + row) = record;
+						updatedIds << id;
+					}
+				}
+			}
+
+			for (auto span : ranges(model, updatedIds))
+				emit model->dataChanged(model->index(span.first, 0), model->index(span.second, model->columnCount() - 1));
+		}
+
+		template<class Model>
+		static void appendRows(Model *model, const QList<long> &ids, const bool prepend)
+		{
+			if (ids.isEmpty())
+				return;
+
+			Store records;
+
+			for (auto id : ids) {
+				if (!model->containsId(id)) {
+					auto record = NotifyRecordCache<Store>::fetch(id);
+
+					if (record)
+						records.push_back(record);
+				}
+			}
+
+			if (prepend) {
+				std::reverse(records.begin(), records.end());
+				insertRecords(model, 0, std::move(records));
+			}
+			else
+				appendRecords(model, std::move(records));
+		}
+	};
+
+	/**
+	*
+	* \brief Локальный кэш снимков недавно открытых сценариев
+	*
+	* Переменные и файлы сценария (их проекции) сохраняются в каталоге кэша приложения в двоичном виде вместе
+	* с их контрольной суммой, вычисленной БД. При повторном открытии окно отображает копию из кэша сразу, а
+	* загрузчик сверяет сумму с БД и перечитывает данные только при ее несовпадении. Хранятся снимки
+	* MaxEntries последних открытых сценариев.
+	*
+	*/
+	class EmulationSnapshotCache
+	{
+	public:
+		static const int MaxEntries = 32; ///< Количество хранимых снимков
+
+		/**
+		*
+		* \brief Функция возвращает снимок сценария из кэша или пустой указатель при его отсутствии
+		*
+		* \param emulationId - идентификатор сценария
+		*
+		*/
+		static std::shared_ptr<EmulationSnapshot> read(const long emulationId);
+
+		/**
+		*
+		* \brief Функция сохраняет переменные и файлы снимка в кэше
+		*
+		* \param snapshot - снимок, содержащий переменные и файлы сценария
+		*
+		*/
+		static bool write(const EmulationSnapshot &snapshot);
+
+		/// Функция удаляет снимок сценария из кэша
+		static void remove(const long emulationId);
+
+	private:
+		static const quint32 Magic = 0x454d5353; ///< Сигнатура файла снимка
+		static const quint16 FormatVersion = 3; ///< Версия формата файла снимка
+
+		/// Функция возвращает каталог кэша снимков
+		static QString directory();
+
+		/// Функция возвращает имя файла снимка сценария
+		static QString fileName(const long emulationId);
+
+		/// Функция удаляет снимки сценариев, открывавшихся раньше остальных, сверх MaxEntries
+		static void prune();
+	};
+
+}
@@ -0,0 +1,192 @@
+﻿/**
+*
+* \file
+*
+* \brief Представления ODB для просмотра переменных и файлов сценариев и потоковой передачи содержимого файлов
+*
+* Представления ODB возвращают только отображаемые столбцы: содержимое передается в виде размера, контрольной
+* суммы MD5 и начального фрагмента, вычисляемых на стороне БД. Заголовок обрабатывается компилятором ODB
+* вместе с описаниями объектов emulation_dal.
+*
+*/
+#pragma once
+
+#include "emulation_baseclasses.h"
+
+#include <memory>
+#include <vector>
+
+#include <odb/core.hxx>
+#include <odb/nullable.hxx>
+
+namespace Emulation
+{
+
+	/**
+	*
+	* \brief Строка таблицы просмотра переменных сценария
+	*
+	* Наименование типа не присоединяется запросом, а берется из кэша справочника типов EmulationTypesCache.
+	*
+	*/
+	#pragma db view object(emulation_dal::Emulation_variable) pointer(std::shared_ptr)
+	struct EmulationVariableRow
+	{
+		#pragma db column("id")
+		long recordId = 0; ///< Индекс БД
+
+		#pragma db column("emulation")
+		long emulationId = 0; ///< Идентификатор сценария
+
+		#pragma db column("ev_name")
+		QString name; ///< Наименование переменной
+
+		#pragma db column("evt")
+		long typeId = 0; ///< Идентификатор типа переменной
+
+		#pragma db column("ev_length")
+		odb::nullable<__int64> length; ///< Длина переменной
+
+		#pragma db column("ev_description")
+		QString description; ///< Описание переменной
+
+		#pragma db column("ev_data_ready")
+		bool dataReady = false; ///< Признак наличия значения по умолчанию
+
+		#pragma db column("coalesce(octet_length(ev_data), 0)")
+		qint64 dataSize = 0; ///< Размер значения в байтах
+
+		// Длина фрагмента совпадает с PayloadPreview::DefaultLength
+		#pragma db column("substring(ev_data from 1 for 64)")
+		QByteArray dataPrefix; ///< Начальный фрагмент значения
+
+		#pragma db column("md5(ev_data)")
+		QString dataHash; ///< Контрольная сумма значения
+
+		/// Функция возвращает индекс БД
+		long id() const { return recordId; }
+	};
+
+	/**
+	*
+	* \brief Строка таблицы просмотра файлов сценария
+	*
+	* Наименование типа не присоединяется запросом, а берется из кэша справочника типов EmulationTypesCache.
+	*
+	*/
+	#pragma db view object(emulation_dal::Emulation_file) pointer(std::shared_ptr)
+	struct EmulationFileRow
+	{
+		static const int PrefixLength = 80; ///< Длина начального фрагмента содержимого, передаваемого проекцией
+
+		#pragma db column("id")
+		long recordId = 0; ///< Индекс БД
+
+		#pragma db column("emulation")
+		long emulationId = 0; ///< Идентификатор сценария
+
+		#pragma db column("ef_name")
+		QString name; ///< Наименование файла
+
+		#pragma db column("eft")
+		long typeId = 0; ///< Идентификатор типа файла
+
+		#pragma db column("ef_data_ready")
+		bool dataReady = false; ///< Признак наличия содержимого
+
+		#pragma db column("ef_use_file_store")
+		bool useFileStore = false; ///< Признак хранения содержимого в файловом хранилище
+
+		#pragma db column("ef_description")
+		QString description; ///< Описание файла
+
+		#pragma db column("coalesce(octet_length(ef_data), 0)")
+		qint64 dataSize = 0; ///< Размер содержимого в байтах
+
+		// Длина фрагмента совпадает с PrefixLength, фрагмент вмещает ссылку на объект EmulationFileStore
+		#pragma db column("substring(ef_data from 1 for 80)")
+		QByteArray dataPrefix; ///< Начальный фрагмент содержимого
+
+		#pragma db column("md5(ef_data)")
+		QString dataHash; ///< Контрольная сумма содержимого
+
+		/// Функция возвращает индекс БД
+		long id() const { return recordId; }
+	};
+
+	/**
+	*
+	* \brief Фрагмент содержимого файла сценария, читаемый из БД при потоковой передаче
+	*
+	* Каждый запрос возвращает один фрагмент: условие задает файл (f.id) и начало фрагмента (s.first, от 1),
+	* поэтому содержимое передается из БД порциями ограниченного размера. Длина фрагмента совпадает с
+	* EmulationFileTransfer::ChunkSize.
+	*
+	*/
+	#pragma db view query("SELECT substring(f.ef_data from s.first for 1048576) FROM \"Emulation_file\" f " \
+		"CROSS JOIN generate_series(1, octet_length(f.ef_data), 1048576) s(first) " \
+		"WHERE (?)")
+	struct EmulationFileChunk
+	{
+		QByteArray data; ///< Фрагмент содержимого
+	};
+
+	/**
+	*
+	* \brief Ссылка на объект файлового хранилища, записанная в файле сценария
+	*
+	* Передаются только ссылки (ef_data длиной EmulationFileStore::ReferenceLength) файлов сценариев, использующих
+	* хранилище с заданным корневым каталогом; содержимое остальных файлов не читается.
+	*
+	*/
+	#pragma db view query("SELECT substring(f.ef_data from 1 for 71) FROM \"Emulation_file\" f " \
+		"JOIN \"Emulation\" e ON e.id = f.emulation " \
+		"WHERE f.ef_use_file_store AND octet_length(f.ef_data) = 71 AND (?)")
+	struct EmulationFileReference
+	{
+		QByteArray reference; ///< Ссылка на объект хранилища
+	};
+
+	/**
+	*
+	* \brief Контрольная сумма переменных сценария, вычисляемая БД
+	*
+	* Сверяется с копией переменных из локального кэша: изменение, добавление или удаление переменной меняет
+	* сумму, даже если время изменения сценария осталось прежним.
+	*
+	*/
+	#pragma db view object(emulation_dal::Emulation_variable)
+	struct EmulationVariablesDigest
+	{
+		#pragma db column("count(id)")
+		qint64 count = 0; ///< Количество переменных
+
+		#pragma db column("coalesce(max(id), 0)")
+		qint64 maxId = 0; ///< Максимальный индекс БД
+
+		#pragma db column("coalesce(md5(string_agg(concat_ws('|', id, ev_name, evt, ev_length, ev_description, ev_data_ready, md5(ev_data)), '|' order by id)), '')")
+		QString checksum; ///< Контрольная сумма столбцов и значений переменных
+	};
+
+	/**
+	*
+	* \brief Контрольная сумма файлов сценария, вычисляемая БД
+	*
+	*/
+	#pragma db view object(emulation_dal::Emulation_file)
+	struct EmulationFilesDigest
+	{
+		#pragma db column("count(id)")
+		qint64 count = 0; ///< Количество файлов
+
+		#pragma db column("coalesce(max(id), 0)")
+		qint64 maxId = 0; ///< Максимальный индекс БД
+
+		#pragma db column("coalesce(md5(string_agg(concat_ws('|', id, ef_name, eft, ef_data_ready, ef_use_file_store, ef_description, md5(ef_data)), '|' order by id)), '')")
+		QString checksum; ///< Контрольная сумма столбцов и содержимого файлов
+	};
+
+	typedef std::vector<std::shared_ptr<EmulationVariableRow>> EmulationVariableRowStore; ///< Список строк переменных
+	typedef std::vector<std::shared_ptr<EmulationFileRow>> EmulationFileRowStore; ///< Список строк файлов
+
+}
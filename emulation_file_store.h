@@ -0,0 +1,173 @@
+﻿/**
+*
+* \file
+*
+* \brief Файловое хранилище содержимого файлов сценариев эмуляционного моделирования
+*
+*/
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+
+#include <memory>
+
+class QMutex;
+
+namespace Emulation
+{
+
+	class EmulationFileMapping;
+
+	/**
+	*
+	* \brief Файловое хранилище содержимого файлов сценариев с адресацией по содержимому
+	*
+	* Содержимое сохраняется один раз под своей контрольной суммой SHA-256 в каталоге objects корня хранилища
+	* (emulation_file_store_path), а запись Emulation_file хранит в ef_data только ссылку вида "sha256:<сумма>".
+	* Сценарии, использующие одинаковые образы и конфигурации, ссылаются на один объект хранилища, поэтому
+	* копирование записей не копирует содержимое.
+	*
+	* Ссылка записывается только в записи с установленным ef_use_file_store и имеет длину ReferenceLength: префикс
+	* "sha256:" и 64 строчные шестнадцатеричные цифры. Содержимое записи без ef_use_file_store ссылкой не считается,
+	* поэтому читатели ef_data проверяют и ef_use_file_store, и isReference, а ссылку разрешают через хранилище сценария.
+	*
+	*/
+	class EmulationFileStore
+	{
+	public:
+		static const int ReferenceLength = 71; ///< Длина ссылки на объект хранилища
+
+		/// Сведения об использовании хранилища
+		struct Usage
+		{
+			int references = 0; ///< Количество ссылок на объекты хранилища
+			int objects = 0; ///< Количество различных объектов, на которые есть ссылки
+			qint64 referencedSize = 0; ///< Суммарный размер содержимого по всем ссылкам
+			qint64 storedSize = 0; ///< Суммарный размер объектов, на которые есть ссылки
+
+			/// Функция возвращает объем, сэкономленный за счет однократного хранения содержимого
+			qint64 savedSize() const;
+		};
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param root - корневой каталог хранилища
+		*
+		*/
+		explicit EmulationFileStore(const QString &root = QString());
+
+		/// Функция возвращает корневой каталог хранилища
+		QString root() const;
+
+		/// Функция возвращает признак заданного корневого каталога
+		bool isValid() const;
+
+		/// Функция возвращает путь к объекту хранилища с заданной контрольной суммой
+		QString path(const QString &hash) const;
+
+		/// Функция возвращает признак наличия объекта в хранилище
+		bool contains(const QString &hash) const;
+
+		/// Функция возвращает размер объекта хранилища или -1 при его отсутствии
+		qint64 size(const QString &hash) const;
+
+		/**
+		*
+		* \brief Функция помещает содержимое в хранилище и возвращает его контрольную сумму
+		*
+		* Содержимое, уже присутствующее в хранилище, повторно не записывается; объект, не совпадающий с ним,
+		* атомарно заменяется. При ошибке записи возвращается пустая строка.
+		*
+		* \param data - содержимое
+		*
+		*/
+		QString put(const QByteArray &data) const;
+
+		/// Функция возвращает содержимое объекта хранилища
+		QByteArray get(const QString &hash) const;
+
+		/// Функция возвращает отображение объекта хранилища в память или nullptr при его отсутствии
+		std::shared_ptr<const EmulationFileMapping> map(const QString &hash) const;
+
+		/**
+		*
+		* \brief Функция возвращает сведения об использовании хранилища заданными ссылками
+		*
+		* \param hashes - контрольные суммы из ссылок записей, по одной на каждую ссылку
+		*
+		*/
+		Usage usage(const QStringList &hashes) const;
+
+		/// Функция возвращает ссылку на объект хранилища для записи в ef_data
+		static QByteArray reference(const QString &hash);
+
+		/// Функция возвращает признак того, что значение ef_data является ссылкой на объект хранилища
+		static bool isReference(const QByteArray &data);
+
+		/// Функция возвращает контрольную сумму из ссылки или пустую строку, если значение не является ссылкой
+		static QString hash(const QByteArray &reference);
+
+		/// Функция возвращает контрольные суммы ссылок на объекты хранилища из файлов всех использующих его сценариев
+		QStringList references() const;
+
+	private:
+		QString m_root; ///< Корневой каталог хранилища
+	};
+
+	/**
+	*
+	* \brief Отображение объекта файлового хранилища в память только для чтения
+	*
+	* Объекты хранилища не изменяются после записи, поэтому одно отображение файла используется совместно всеми
+	* потребителями процесса: повторное открытие, пока отображение удерживается хотя бы одним из них, возвращает
+	* его же. Чтение выполняется без копирования в кучу, повторные обращения обслуживаются страничным кэшем ОС.
+	*
+	*/
+	class EmulationFileMapping
+	{
+	public:
+		~EmulationFileMapping();
+
+		/**
+		*
+		* \brief Функция возвращает отображение файла, при необходимости создавая его
+		*
+		* \param path - путь к файлу
+		*
+		*/
+		static std::shared_ptr<const EmulationFileMapping> open(const QString &path);
+
+		/// Функция возвращает путь к отображенному файлу
+		QString path() const;
+
+		/// Функция возвращает указатель на начало содержимого
+		const char *data() const;
+
+		/// Функция возвращает размер содержимого
+		qint64 size() const;
+
+		/// Функция возвращает содержимое без копирования; значение действительно, пока удерживается отображение
+		QByteArray bytes() const;
+
+		/// Функция возвращает количество отображений, используемых в процессе
+		static int count();
+
+	private:
+		explicit EmulationFileMapping(const QString &path);
+
+		EmulationFileMapping(const EmulationFileMapping &) = delete;
+		EmulationFileMapping &operator=(const EmulationFileMapping &) = delete;
+
+		static QHash<QString, std::weak_ptr<const EmulationFileMapping>> &registry();
+		static QMutex &registryMutex();
+
+		QFile m_file; ///< Отображенный файл
+		uchar *m_data; ///< Начало отображения
+		qint64 m_size; ///< Размер отображения
+	};
+
+}
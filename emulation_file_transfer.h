@@ -0,0 +1,381 @@
+﻿/**
+*
+* \file
+*
+* \brief Сжатие, потоковая передача и проверка целостности содержимого файлов сценариев эмуляционного моделирования
+*
+*/
+#pragma once
+
+#include "emulation_baseclasses.h"
+#include "emulation_file_store.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <functional>
+
+class QProgressDialog;
+class QCryptographicHash;
+class QThreadPool;
+
+namespace Emulation
+{
+
+	/**
+	*
+	* \brief Сжатие содержимого файлов сценариев, хранимого в БД
+	*
+	* Сжатое содержимое начинается с заголовка (сигнатура, кодек, исходный размер), за которым следуют блоки не
+	* более BlockLength исходных байт. Первый блок содержит HeadLength байт без сжатия, поэтому начальный фрагмент
+	* проекции EmulationFileRow пригоден для просмотра. Содержимое без заголовка считается несжатым, поэтому ранее
+	* сохраненные записи читаются без преобразования. Объекты файлового хранилища не сжимаются: они читаются
+	* через отображение в память.
+	*
+	* Признак сжатия хранится в самом ef_data, отдельного столбца в схеме emulation_dal нет, поэтому содержимое
+	* записи читается и записывается только функциями data и setData; читатели вне этого модуля должны
+	* распаковывать его функцией decode. Сжимаются только файлы типов, перечисленных в codec.
+	*
+	*/
+	class EmulationFileCodec
+	{
+	public:
+		/// Кодеки содержимого
+		enum Codec
+		{
+			None = 0, ///< Без сжатия
+			Zlib = 1 ///< Сжатие zlib (qCompress)
+		};
+
+		static const int HeaderLength = 13; ///< Длина заголовка сжатого содержимого
+		static const int HeadLength = 48; ///< Длина начального блока без сжатия
+		static const int BlockLength = 1 << 20; ///< Наибольшая исходная длина блока
+
+		/// Функция, получающая количество обработанных байт и общий размер содержимого
+		typedef std::function<void(const qint64 done, const qint64 total)> Progress;
+
+		/**
+		*
+		* \brief Класс, служащий для распаковки содержимого, поступающего порциями
+		*
+		* Содержимое без заголовка передается без изменений. В памяти удерживается только неполный блок.
+		*
+		*/
+		class Decoder
+		{
+		public:
+			/**
+			*
+			* \brief Конструктор
+			*
+			* \param target - устройство, в которое записывается исходное содержимое
+			*
+			*/
+			explicit Decoder(QIODevice *target);
+
+			/// Функция принимает очередную порцию содержимого
+			bool write(const char *data, const qint64 length);
+
+			/// Функция завершает распаковку и проверяет целостность содержимого
+			bool finish();
+
+		private:
+			/// Функция распаковывает накопленные целые блоки
+			bool process();
+
+			enum State { Detect, Raw, Blocks };
+
+			QIODevice *m_target; ///< Устройство для исходного содержимого
+			QByteArray m_buffer; ///< Накопленная неполная часть содержимого
+			State m_state; ///< Состояние разбора
+			qint64 m_size; ///< Исходный размер из заголовка
+			qint64 m_written; ///< Количество записанных исходных байт
+		};
+
+		/// Функция возвращает кодек, выбираемый для файлов заданного типа
+		static Codec codec(const std::shared_ptr<emulation_dal::Emulation_file_type> &type);
+
+		/// Функция возвращает исходное содержимое записи файла
+		static QByteArray data(const emulation_dal::Emulation_file &file);
+
+		/// Функция записывает в запись файла хранимое (возможно, сжатое функцией encode) содержимое
+		static void setData(emulation_dal::Emulation_file &file, const QByteArray &storedData);
+
+		/// Функция возвращает кодек, которым сжато содержимое
+		static Codec codec(const QByteArray &data);
+
+		/**
+		*
+		* \brief Функция сжимает содержимое
+		*
+		* Если сжатие не уменьшает размер или отменено, возвращается исходное содержимое.
+		*
+		* \param data - исходное содержимое
+		* \param codec - кодек
+		* \param progress - функция, получающая сведения о ходе сжатия
+		* \param cancelFlag - признак отмены
+		*
+		*/
+		static QByteArray encode(const QByteArray &data, const Codec codec, const Progress &progress = Progress(),
+			const std::shared_ptr<QAtomicInt> &cancelFlag = nullptr);
+
+		/// Функция возвращает исходное содержимое или пустое значение при повреждении сжатого содержимого
+		static QByteArray decode(const QByteArray &data);
+
+		/**
+		*
+		* \brief Функция возвращает исходный размер содержимого по его начальному фрагменту
+		*
+		* \param prefix - начальный фрагмент хранимого содержимого
+		* \param storedSize - размер хранимого содержимого
+		*
+		*/
+		static qint64 size(const QByteArray &prefix, const qint64 storedSize);
+
+		/// Функция возвращает доступное для просмотра начало исходного содержимого по начальному фрагменту хранимого
+		static QByteArray head(const QByteArray &prefix);
+
+	private:
+		/// Функция возвращает признак наличия заголовка сжатого содержимого
+		static bool hasHeader(const QByteArray &data);
+
+		static const char Magic[5]; ///< Сигнатура сжатого содержимого
+		static const quint32 RawBlockFlag = 0x80000000u; ///< Признак блока без сжатия в длине блока
+	};
+
+	/**
+	*
+	* \brief Класс, служащий для потоковой передачи содержимого файлов сценариев
+	*
+	* Содержимое передается порциями ChunkSize с ограниченным расходом памяти: из файлового хранилища - чтением
+	* объекта, из БД - запросами фрагментов. Функции сообщают о ходе передачи и проверяют признак отмены между
+	* порциями. Функция exec выполняет передачу в фоновом потоке, отображая диалог хода выполнения.
+	*
+	*/
+	class EmulationFileTransfer : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		static const qint64 ChunkSize = 1 << 20; ///< Размер порции передачи, совпадает с длиной фрагмента EmulationFileChunk
+		static const qint64 MaxDatabasePayload = 256 << 20; ///< Наибольший размер содержимого, хранимого в БД
+
+		/// Функция, получающая количество переданных байт и общий размер содержимого
+		typedef std::function<void(const qint64 done, const qint64 total)> Progress;
+
+		/// Функция передачи, выполняемая функцией exec
+		typedef std::function<bool(const Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag)> Job;
+
+		/**
+		*
+		* \brief Функция передает содержимое сохраненного файла сценария из БД или файлового хранилища
+		*
+		* Запись целиком не читается: ссылка и размер содержимого берутся из проекции EmulationFileRow.
+		*
+		* \param fileId - индекс БД файла сценария
+		* \param store - файловое хранилище сценария
+		* \param target - устройство, в которое записывается содержимое
+		* \param progress - функция, получающая сведения о ходе передачи
+		* \param cancelFlag - признак отмены
+		*
+		*/
+		static bool read(const long fileId, const EmulationFileStore &store, QIODevice *target, const Progress &progress = Progress(),
+			const std::shared_ptr<QAtomicInt> &cancelFlag = nullptr);
+
+		/**
+		*
+		* \brief Функция передает содержимое записи файла сценария, в том числе еще не сохраненной
+		*
+		* \param file - запись файла сценария
+		* \param store - файловое хранилище сценария
+		* \param target - устройство, в которое записывается содержимое
+		* \param progress - функция, получающая сведения о ходе передачи
+		* \param cancelFlag - признак отмены
+		*
+		*/
+		static bool read(const std::shared_ptr<emulation_dal::Emulation_file> &file, const EmulationFileStore &store, QIODevice *target,
+			const Progress &progress = Progress(), const std::shared_ptr<QAtomicInt> &cancelFlag = nullptr);
+
+		/**
+		*
+		* \brief Функция помещает содержимое устройства в файловое хранилище и возвращает его контрольную сумму
+		*
+		* Содержимое записывается во временный файл хранилища с одновременным подсчетом контрольной суммы и затем
+		* переименовывается в объект хранилища. При ошибке или отмене возвращается пустая строка.
+		*
+		* \param store - файловое хранилище сценария
+		* \param source - устройство, из которого читается содержимое
+		* \param progress - функция, получающая сведения о ходе передачи
+		* \param cancelFlag - признак отмены
+		*
+		*/
+		static QString writeToStore(const EmulationFileStore &store, QIODevice *source, const Progress &progress = Progress(),
+			const std::shared_ptr<QAtomicInt> &cancelFlag = nullptr);
+
+		/**
+		*
+		* \brief Функция читает содержимое устройства порциями для сохранения в БД
+		*
+		* \param source - устройство, из которого читается содержимое
+		* \param target - прочитанное содержимое
+		* \param progress - функция, получающая сведения о ходе передачи
+		* \param cancelFlag - признак отмены
+		*
+		*/
+		static bool readDevice(QIODevice *source, QByteArray &target, const Progress &progress = Progress(),
+			const std::shared_ptr<QAtomicInt> &cancelFlag = nullptr);
+
+		/**
+		*
+		* \brief Функция выполняет передачу в фоновом потоке, отображая модальный диалог хода выполнения
+		*
+		* \param parent - родительский виджет диалога
+		* \param label - описание передачи
+		* \param job - функция передачи
+		*
+		*/
+		static bool exec(QWidget *parent, const QString &label, const Job &job);
+
+	signals:
+		/// Сигнал испускается потоком передачи после каждой порции
+		void progress(qint64 done, qint64 total);
+
+	private slots:
+		void updateProgress(qint64 done, qint64 total);
+		void cancel();
+
+	private:
+		/// Конструктор
+		explicit EmulationFileTransfer(QProgressDialog *dialog);
+
+		/// Функция копирует содержимое устройства порциями
+		static bool copy(QIODevice *source, QIODevice *target, const qint64 total, const Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag,
+			QCryptographicHash *hash = nullptr);
+
+		/// Функция копирует объект файлового хранилища
+		static bool readObject(const EmulationFileStore &store, const QString &hash, QIODevice *target, const Progress &progress,
+			const std::shared_ptr<QAtomicInt> &cancelFlag);
+
+		/// Функция возвращает признак отмены передачи
+		static bool isCanceled(const std::shared_ptr<QAtomicInt> &cancelFlag);
+
+		/// Функция возвращает признак совпадения объекта хранилища с содержимым открытого файла
+		static bool isStored(const EmulationFileStore &store, const QString &hash, QFile &file);
+
+		QProgressDialog *m_dialog; ///< Диалог хода выполнения
+		std::shared_ptr<QAtomicInt> m_cancelFlag; ///< Признак отмены передачи
+	};
+
+	/**
+	*
+	* \brief Класс фоновой проверки целостности объектов файлового хранилища
+	*
+	* Объекты читаются заново (не через общие отображения EmulationFileMapping, которые могут удерживать уже
+	* замененный файл) в пуле из не более MaxThreadCount потоков, их контрольная сумма SHA-256 сравнивается
+	* с суммой из ссылки. Суммарная скорость чтения ограничена MaxBytesPerSecond, чтобы проверка не мешала
+	* работе с хранилищем. Каждый объект проверяется один раз до смены хранилища.
+	*
+	*/
+	class EmulationFileStoreVerifier : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		/// Состояния объекта хранилища
+		enum Status
+		{
+			Unknown = 0, ///< Объект не проверялся
+			Pending, ///< Объект ожидает проверки
+			Intact, ///< Содержимое объекта соответствует контрольной сумме
+			Missing, ///< Объект отсутствует или не читается
+			Damaged ///< Содержимое объекта не соответствует контрольной сумме
+		};
+
+		static const int MaxThreadCount = 2; ///< Наибольшее количество потоков проверки
+		static const qint64 MaxBytesPerSecond = 64 << 20; ///< Наибольшая суммарная скорость чтения
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		explicit EmulationFileStoreVerifier(QObject *parent = nullptr);
+
+		~EmulationFileStoreVerifier();
+
+		/**
+		*
+		* \brief Функция служит для смены проверяемого хранилища
+		*
+		* Выполняющаяся проверка отменяется, результаты предыдущих проверок сбрасываются.
+		*
+		* \param store - файловое хранилище сценария
+		*
+		*/
+		void reset(const EmulationFileStore &store);
+
+		/**
+		*
+		* \brief Функция ставит в очередь проверки еще не проверявшиеся объекты
+		*
+		* \param hashes - контрольные суммы объектов
+		*
+		*/
+		void verify(const QStringList &hashes);
+
+		/// Функция возвращает состояние объекта с заданной контрольной суммой
+		Status status(const QString &hash) const;
+
+		/// Функция возвращает количество объектов в заданном состоянии
+		int count(const Status value) const;
+
+		/// Функция возвращает признак выполнения проверки
+		bool isRunning() const;
+
+	signals:
+		/// Сигнал о завершении проверки объекта
+		void objectVerified(const QString &hash, int status);
+
+		/// Сигнал о завершении проверки всех поставленных в очередь объектов
+		void finished();
+
+	private slots:
+		/// Слот служит для применения результата проверки, передаваемого из потока пула
+		void applyResult(int generation, const QString &hash, int status);
+
+	private:
+		/// Ограничитель суммарной скорости чтения потоков проверки
+		class Throttle
+		{
+		public:
+			explicit Throttle(const qint64 bytesPerSecond);
+
+			/// Функция приостанавливает поток, если прочитано больше, чем допускает ограничение скорости
+			void acquire(const qint64 bytes);
+
+		private:
+			QMutex m_mutex; ///< Защита счетчиков
+			QElapsedTimer m_timer; ///< Время с начала проверки
+			qint64 m_bytes; ///< Количество прочитанных байт
+			qint64 m_bytesPerSecond; ///< Наибольшая скорость чтения
+		};
+
+		/// Функция проверяет объект хранилища
+		static Status check(const EmulationFileStore &store, const QString &hash, Throttle &throttle, const std::shared_ptr<QAtomicInt> &cancelFlag);
+
+		/// Функция отменяет выполняющуюся проверку
+		void cancel();
+
+		QThreadPool *m_pool; ///< Пул потоков проверки
+		EmulationFileStore m_store; ///< Проверяемое хранилище
+		QHash<QString, Status> m_statuses; ///< Состояния объектов
+		std::shared_ptr<QAtomicInt> m_cancelFlag; ///< Признак отмены текущей проверки
+		std::shared_ptr<Throttle> m_throttle; ///< Ограничитель скорости текущей проверки
+		int m_generation; ///< Номер текущей проверки, результаты предыдущих отбрасываются
+		QHash<int, int> m_counts; ///< Количество объектов в каждом состоянии
+	};
+
+}
@@ -1,6 +1,9 @@
 #include "stdafx.h"
 
 #include "emulation_widgets.h"
+#include "emulation_display_rows-odb.hxx"
+#include "emulation_db_cache.h"
+#include "emulation_file_transfer.h"
 
 #include "emulation_supportwidgets.h"
 #include "emulation_scenery.h"
@@ -11,6 +14,20 @@
 #include "emulation_delegates.h"
 #include "topology2d/topology2d_host.h"
 
+#include <QtConcurrent>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QFileDialog>
+#include <QBuffer>
+#include <QtEndian>
+#include <QThread>
+#include <QThreadPool>
+#include <QProgressDialog>
+#include <QCryptographicHash>
+
+#include <limits>
+
 namespace Emulation
 {
 
@@ -85,7 +102,7 @@ namespace Emulation
 		if (data) {
 
 			name(data->ev_name());
-			variableType(data->evt());
+			variableType(EmulationTypesCache::instance()->variableType(data->evt_id()));
 
 			if (!data->ev_length().null()) {
 				lenght(data->ev_length().get());
@@ -249,6 +266,26 @@ namespace Emulation
 		mainLayout->addWidget(descriptionLabel, 5, 0);
 		mainLayout->addWidget(m_descriptionEdit, 5, 1);
 
+		QLabel *contentLabel = new QLabel(tr("Content"), this);
+		m_contentLine = new QLineEdit(this);
+		m_contentLine->setReadOnly(true);
+
+		QPushButton *loadButton = new QPushButton(tr("Load..."), this);
+		QPushButton *saveButton = new QPushButton(tr("Save as..."), this);
+
+		QHBoxLayout *contentLayout = new QHBoxLayout;
+		contentLayout->addWidget(m_contentLine);
+		contentLayout->addWidget(loadButton);
+		contentLayout->addWidget(saveButton);
+
+		mainLayout->addWidget(contentLabel, 4, 0);
+		mainLayout->addLayout(contentLayout, 4, 1);
+
+		connect(loadButton, SIGNAL(clicked()), SLOT(loadContent()));
+		connect(saveButton, SIGNAL(clicked()), SLOT(saveContent()));
+
+		updateContentLine();
+
 	}
 
 	void EditFilesForm::loadDBData(const std::shared_ptr<emulation_dal::Emulation_file> &data)
@@ -258,11 +295,16 @@ namespace Emulation
 			m_dbData = data;
 
 			name(data->ef_name());
-			fileType(data->eft());
+			fileType(EmulationTypesCache::instance()->fileType(data->eft_id()));
 
 			useStoreFlag(data->ef_use_file_store());
 			description(data->ef_description());
 
+			m_content.clear();
+			m_contentChanged = false;
+
+			updateContentLine();
+
 		}
 	}
 
@@ -325,6 +367,134 @@ namespace Emulation
 		m_dbData->ef_use_file_store(useStoreFlag());
 		m_dbData->ef_description(description());
 
+		if (m_contentChanged) {
+			auto content = m_content;
+			auto codec = EmulationFileStore::isReference(content) ? EmulationFileCodec::None
+				: EmulationFileCodec::codec(EmulationTypesCache::instance()->fileType(fileTypeId()));
+
+			if (codec != EmulationFileCodec::None) {
+				EmulationFileTransfer::exec(this, tr("Compressing file content..."),
+					[&content, codec](const EmulationFileTransfer::Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag) {
+						content = EmulationFileCodec::encode(content, codec, progress, cancelFlag);
+
+						return true;
+					});
+			}
+
+			EmulationFileCodec::setData(*m_dbData, content);
+			m_dbData->ef_data_ready(true);
+		}
+
+	}
+
+	void EditFilesForm::fileStorePath(const QString &value)
+	{
+		m_fileStorePath = value;
+	}
+
+	void EditFilesForm::loadContent()
+	{
+		auto fileName = QFileDialog::getOpenFileName(this, tr("Load file content"));
+
+		if (fileName.isEmpty())
+			return;
+
+		QFile source(fileName);
+
+		if (!source.open(QIODevice::ReadOnly)) {
+			Global::Messages::ErrorMessage(tr("Unable to open file ") + fileName);
+			return;
+		}
+
+		EmulationFileStore store(useStoreFlag() ? m_fileStorePath : QString());
+
+		if (!store.isValid() && source.size() > EmulationFileTransfer::MaxDatabasePayload) {
+			Global::Messages::ErrorMessage(tr("File is too large to be stored in the database, use the file store"));
+			return;
+		}
+
+		QByteArray content;
+		QFile *device = &source;
+
+		bool loaded = EmulationFileTransfer::exec(this, tr("Loading file content..."),
+			[store, device, &content](const EmulationFileTransfer::Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag) {
+				if (!store.isValid())
+					return EmulationFileTransfer::readDevice(device, content, progress, cancelFlag);
+
+				auto hash = EmulationFileTransfer::writeToStore(store, device, progress, cancelFlag);
+
+				if (hash.isEmpty())
+					return false;
+
+				content = EmulationFileStore::reference(hash);
+
+				return true;
+			});
+
+		if (!loaded)
+			return;
+
+		m_content = content;
+		m_contentChanged = true;
+
+		if (name().isEmpty())
+			name(QFileInfo(fileName).fileName());
+
+		updateContentLine();
+	}
+
+	void EditFilesForm::saveContent()
+	{
+		auto fileName = QFileDialog::getSaveFileName(this, tr("Save file content"), name());
+
+		if (fileName.isEmpty())
+			return;
+
+		QSaveFile target(fileName);
+
+		if (!target.open(QIODevice::WriteOnly)) {
+			Global::Messages::ErrorMessage(tr("Unable to open file ") + fileName);
+			return;
+		}
+
+		auto file = m_dbData;
+
+		if (m_contentChanged) {
+			file = std::make_shared<emulation_dal::Emulation_file>(*m_dbData);
+			EmulationFileCodec::setData(*file, m_content);
+		}
+
+		EmulationFileStore store(m_fileStorePath);
+
+		bool saved = EmulationFileTransfer::exec(this, tr("Saving file content..."),
+			[file, store, &target](const EmulationFileTransfer::Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag) {
+				return EmulationFileTransfer::read(file, store, &target, progress, cancelFlag);
+			});
+
+		if (saved)
+			target.commit();
+		else
+			target.cancelWriting();
+	}
+
+	void EditFilesForm::updateContentLine()
+	{
+		const QByteArray &content = m_contentChanged ? m_content : m_dbData->ef_data();
+
+		if (!m_contentChanged && m_dbData->ef_use_file_store() && EmulationFileStore::isReference(content)) {
+			EmulationFileStore store(m_fileStorePath);
+			auto hash = EmulationFileStore::hash(content);
+
+			auto objectSize = store.size(hash);
+
+			m_contentLine->setText(QString("[%1] sha256:%2%3").arg(objectSize >= 0 ? PayloadPreview::size(objectSize) : tr("missing"),
+				hash.left(12), QChar(0x2026)));
+		}
+		else if (EmulationFileCodec::codec(content) != EmulationFileCodec::None)
+			m_contentLine->setText(tr("%1, compressed to %2").arg(PayloadPreview::size(EmulationFileCodec::size(content, content.size())),
+				PayloadPreview::size(content.size())));
+		else
+			m_contentLine->setText(content.isEmpty() ? tr("No content") : PayloadPreview::size(content.size()));
 	}
 
 	// EditVariablesDialog
@@ -423,1766 +593,5365 @@ namespace Emulation
 		return dynamic_cast<EditFilesForm *>(DialogBase::form());
 	}
 
-	// ViewVariablesTableModel
-	ViewVariablesTableModel::ViewVariablesTableModel(QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_variable>(DoNotAutoLoad, parent)
+	// NotifyEventBatch
+	bool NotifyEventBatch::isEmpty() const
 	{
-		init();
+		return added.isEmpty() && updated.isEmpty() && removed.isEmpty();
 	}
 
-	ViewVariablesTableModel::ViewVariablesTableModel(const Emulation_variable_store &value, QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_variable>(DoNotAutoLoad, parent)
+	int NotifyEventBatch::operationsCount() const
 	{
-		set(value);
-
-		init();
+		return added.size() + updated.size() + removed.size();
 	}
 
-	void ViewVariablesTableModel::init()
+	// QueryStatistics
+	QueryStatistics::QueryStatistics(const QString &name)
+		: m_name(name), m_callsCount(0), m_preparedCount(0), m_totalTime(0)
 	{
+		QMutexLocker locker(&registryMutex());
+
+		registry() << this;
 	}
 
-	QVariant ViewVariablesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	QString QueryStatistics::name() const
 	{
-		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
-			switch (section) {
-			case 0:
-				return QObject::tr("Variable name");
-			case 1:
-				return QObject::tr("Variable type");
-			case 2:
-				return QObject::tr("Lenght");
-			case 3:
-				return QObject::tr("Default value");
-			case 4:
-				return QObject::tr("Description");
-			case 5:
-				return QObject::tr("Value");
-			}
-		}
-
-		return QVariant();
+		return m_name;
 	}
 
-	QVariant ViewVariablesTableModel::data(const QModelIndex &index, int role) const
+	qint64 QueryStatistics::callsCount() const
 	{
-		std::shared_ptr<emulation_dal::Emulation> curEmulation;
-		std::shared_ptr<emulation_dal::Emulation_variable_type> curVariableType;
-		odb::nullable<__int64> curLenght;
-
-		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
-			if (index.row() >= 0 && index.row() < size()) {
-				switch (index.column()) {
-				case 0:
-					return at(index.row())->ev_name();
-
-				case 1:
-					curVariableType = at(index.row())->evt();
-					if (curVariableType)
-						return curVariableType->evt_name();
-					break;
+		return m_callsCount.load();
+	}
 
-				case 2:
-					curLenght = at(index.row())->ev_length();
+	qint64 QueryStatistics::preparedCount() const
+	{
+		return m_preparedCount.load();
+	}
 
-					if (curLenght.null() || curLenght.get() == -1)
-						return QObject::tr("Arbitrary lenght");
-					else
-						return curLenght.get();
+	qint64 QueryStatistics::reusedCount() const
+	{
+		return callsCount() - preparedCount();
+	}
 
-					break;
+	qint64 QueryStatistics::totalTime() const
+	{
+		return m_totalTime.load();
+	}
 
-				case 3:
-					if (at(index.row())->ev_data_ready())
-						return at(index.row())->ev_data();
-					else
-						return "-";
-				case 4:
-					return at(index.row())->ev_description();
-				case 5:
-					return at(index.row())->ev_data();
-				}
-			}
-		}
+	double QueryStatistics::averageTime() const
+	{
+		qint64 calls = callsCount();
 
-		return QVariant();
+		return calls ? totalTime() / 1000.0 / calls : 0.0;
 	}
 
-	int ViewVariablesTableModel::rowCount(const QModelIndex &parent) const
+	void QueryStatistics::addCall(const bool reused, const qint64 nsecs)
 	{
-		return size();
+		m_callsCount.fetchAndAddRelaxed(1);
+		m_totalTime.fetchAndAddRelaxed(nsecs);
+
+		if (!reused)
+			m_preparedCount.fetchAndAddRelaxed(1);
 	}
 
-	int ViewVariablesTableModel::columnCount(const QModelIndex &parent) const
+	void QueryStatistics::reset()
 	{
-		return 6;
+		m_callsCount.store(0);
+		m_preparedCount.store(0);
+		m_totalTime.store(0);
 	}
 
-	// ViewFilesTableModel
-	ViewFilesTableModel::ViewFilesTableModel(QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_file>(DoNotAutoLoad, parent)
+	QList<QueryStatistics *> QueryStatistics::all()
 	{
-		init();
+		QMutexLocker locker(&registryMutex());
+
+		return registry();
 	}
 
-	ViewFilesTableModel::ViewFilesTableModel(const emulation_dal::Emulation_file_store &value, QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_file>(DoNotAutoLoad, parent)
+	QString QueryStatistics::report()
 	{
-		set(value);
+		QStringList lines;
 
-		init();
+		for (auto statistics : all()) {
+			lines << QString("%1: calls %2, prepared %3, reused %4, average %5 us")
+				.arg(statistics->name())
+				.arg(statistics->callsCount())
+				.arg(statistics->preparedCount())
+				.arg(statistics->reusedCount())
+				.arg(statistics->averageTime(), 0, 'f', 1);
+		}
+
+		return lines.join('\n');
 	}
 
-	void ViewFilesTableModel::init()
+	QList<QueryStatistics *> &QueryStatistics::registry()
 	{
+		static QList<QueryStatistics *> value;
 
+		return value;
 	}
 
-	QVariant ViewFilesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	QMutex &QueryStatistics::registryMutex()
 	{
-		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
-			switch (section) {
-			case 0:
-				return QObject::tr("File name");
-			case 1:
-				return QObject::tr("File type");
-			case 2:
-				return QObject::tr("Data flag");
-			case 3:
-				return QObject::tr("Data");
-			case 4:
-				return QObject::tr("Use store");
-			case 5:
-				return QObject::tr("Description");
-			}
-		}
-
-		return QVariant();
+		static QMutex mutex;
 
+		return mutex;
 	}
 
-	QVariant ViewFilesTableModel::data(const QModelIndex &index, int role) const
+	// NotifyEventCoalescer
+	NotifyEventCoalescer::NotifyEventCoalescer(QObject *parent)
+		: QObject(parent), m_eventsCount(0), m_mergedCount(0)
 	{
-		std::shared_ptr<emulation_dal::Emulation> curEmulation;
-		std::shared_ptr<emulation_dal::Emulation_file_type> curFileType;
-		odb::nullable<__int64> curLenght;
-
-		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
-			if (index.row() >= 0 && index.row() < size()) {
-				switch (index.column()) {
-				case 0:
-					return at(index.row())->ef_name();
+		init();
+	}
 
-				case 1:
-					curFileType = at(index.row())->eft();
-					if (curFileType)
-						return curFileType->eft_name();
-					break;
+	void NotifyEventCoalescer::init()
+	{
+		m_timer = new QTimer(this);
+		m_timer->setSingleShot(true);
+		m_timer->setInterval(0);
 
-				case 2:
-					return at(index.row())->ef_data_ready();
-				case 3:
-					return at(index.row())->ef_data();
-				case 4:
-					return at(index.row())->ef_use_file_store();
-				case 5:
-					return at(index.row())->ef_description();
-				}
-			}
-		}
+		connect(m_timer, SIGNAL(timeout()), SLOT(flush()));
+	}
 
-		return QVariant();
+	void NotifyEventCoalescer::setInterval(const int msec)
+	{
+		m_timer->setInterval(qMax(0, msec));
 	}
 
-	int ViewFilesTableModel::columnCount(const QModelIndex &parent) const
+	int NotifyEventCoalescer::interval() const
 	{
-		return 6;
+		return m_timer->interval();
 	}
 
-	// EditVariablesTableModel
-	EditVariablesTableModel::EditVariablesTableModel(QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_variable>(DoNotAutoLoad, parent)
+	int NotifyEventCoalescer::eventsCount() const
 	{
-		init();
+		return m_eventsCount;
 	}
 
-	EditVariablesTableModel::EditVariablesTableModel(emulation_dal::Emulation_variable_store &value, QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_variable>(value, parent)
+	int NotifyEventCoalescer::mergedCount() const
 	{
-		init();
+		return m_mergedCount;
 	}
 
-	void EditVariablesTableModel::init()
+	void NotifyEventCoalescer::schedule()
 	{
+		if (!m_timer->isActive())
+			m_timer->start();
 	}
 
-	QVariant EditVariablesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	void NotifyEventCoalescer::append(const long id)
 	{
-		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
-			switch (section) {
-			case 0:
-				return QObject::tr("Variable name");
-			case 1:
-				return QObject::tr("Variable type");
-			case 2:
-				return QObject::tr("Lenght");
-			case 3:
-				return QObject::tr("Default value");
-			case 4:
-				return QObject::tr("Description");
-			case 5:
-				return QObject::tr("Value");
-			}
+		++m_eventsCount;
+		++m_batch.eventsCount;
+
+		if (!m_addedIds.contains(id)) {
+			m_addedIds.insert(id);
+			m_batch.added << id;
 		}
 
-		return QVariant();
+		schedule();
 	}
 
-	QVariant EditVariablesTableModel::data(const QModelIndex &index, int role) const
+	void NotifyEventCoalescer::update(const long id)
 	{
-		std::shared_ptr<emulation_dal::Emulation> curEmulation;
-		std::shared_ptr<emulation_dal::Emulation_variable_type> curVariableType;
-		odb::nullable<__int64> curLenght;
-
-		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
-			if (index.row() >= 0 && index.row() < size()) {
-				switch (index.column()) {
-				case 0:
-					return at(index.row())->ev_name();
+		++m_eventsCount;
+		++m_batch.eventsCount;
 
-				case 1:
-					curVariableType = at(index.row())->evt();
-					if (curVariableType)
-						return curVariableType->evt_name();
-					break;
+		if (!m_addedIds.contains(id))
+			m_batch.updated.insert(id);
 
-				case 2:
-					curLenght = at(index.row())->ev_length();
+		schedule();
+	}
 
-					if (curLenght.null() || curLenght.get() == -1)
-						return QObject::tr("Arbitrary lenght");
-					else
-						return curLenght.get();
+	void NotifyEventCoalescer::remove(const long id)
+	{
+		++m_eventsCount;
+		++m_batch.eventsCount;
 
-					break;
+		m_batch.updated.remove(id);
 
-				case 3:
-					if (at(index.row())->ev_data_ready())
-						return at(index.row())->ev_data();
-					else
-						return "-";
-				case 4:
-					return at(index.row())->ev_description();
-				case 5:
-					return at(index.row())->ev_data();
-				}
-			}
+		if (m_addedIds.contains(id)) {
+			m_addedIds.remove(id);
+			m_batch.added.removeAll(id);
 		}
+		else
+			m_batch.removed.insert(id);
 
-		return QVariant();
+		schedule();
 	}
 
-	int EditVariablesTableModel::rowCount(const QModelIndex &parent) const
+	void NotifyEventCoalescer::flush()
 	{
-		return size();
+		m_timer->stop();
+
+		if (m_batch.eventsCount == 0)
+			return;
+
+		NotifyEventBatch batch;
+		std::swap(batch, m_batch);
+		m_addedIds.clear();
+
+		m_mergedCount += batch.eventsCount - batch.operationsCount();
+
+		if (!batch.isEmpty())
+			emit batchReady(batch);
 	}
 
-	int EditVariablesTableModel::columnCount(const QModelIndex &parent) const
+	void NotifyEventCoalescer::clear()
 	{
-		return 6;
+		m_timer->stop();
+
+		m_batch = NotifyEventBatch();
+		m_addedIds.clear();
 	}
 
-	// EditVariablesTableModel
-	EditFilesTableModel::EditFilesTableModel(QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_file>(DoNotAutoLoad, parent)
+	// EmulationSession
+	EmulationSession::EmulationSession(QObject *container)
+		: QObject(container), m_session(new odb::session(false))
 	{
-		init();
+		createUpdateConnections();
 	}
 
-	EditFilesTableModel::EditFilesTableModel(emulation_dal::Emulation_file_store &value, QObject *parent)
-		: DBTableModel<emulation_dal::Emulation_file>(value, parent)
+	EmulationSession::~EmulationSession()
 	{
-		init();
+		if (odb::session::current_pointer() == m_session.get())
+			odb::session::current_pointer(nullptr);
 	}
 
-	void EditFilesTableModel::init()
+	EmulationSession *EmulationSession::attach(QObject *container)
 	{
+		if (!container)
+			return nullptr;
+
+		auto existing = container->findChild<EmulationSession *>(QString(), Qt::FindDirectChildrenOnly);
+
+		if (existing)
+			return existing;
+
+		return new EmulationSession(container);
 	}
 
-	QVariant EditFilesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	EmulationSession *EmulationSession::of(const QObject *object)
 	{
-		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
-			switch (section) {
-			case 0:
-				return QObject::tr("File name");
-			case 1:
-				return QObject::tr("File type");
-			case 2:
-				return QObject::tr("Data flag");
-			case 3:
-				return QObject::tr("Data");
-			case 4:
-				return QObject::tr("Use store");
-			case 5:
-				return QObject::tr("Description");
-			}
+		for (; object; object = object->parent()) {
+			auto session = object->findChild<EmulationSession *>(QString(), Qt::FindDirectChildrenOnly);
+
+			if (session)
+				return session;
 		}
 
-		return QVariant();
+		return nullptr;
 	}
 
-	QVariant EditFilesTableModel::data(const QModelIndex &index, int role) const
+	odb::session &EmulationSession::session()
 	{
-		std::shared_ptr<emulation_dal::Emulation> curEmulation;
-		std::shared_ptr<emulation_dal::Emulation_file_type> curFileType;
-		odb::nullable<__int64> curLenght;
-
-		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
-			if (index.row() >= 0 && index.row() < size()) {
-				switch (index.column()) {
-				case 0:
-					return at(index.row())->ef_name();
+		return *m_session;
+	}
 
-				case 1:
-					curFileType = at(index.row())->eft();
-					if (curFileType)
-						return curFileType->eft_name();
-					break;
+	void EmulationSession::clear()
+	{
+		bool current = odb::session::current_pointer() == m_session.get();
 
-				case 2:
-					return at(index.row())->ef_data_ready();
-				case 3:
-					return at(index.row())->ef_data();
-				case 4:
-					return at(index.row())->ef_use_file_store();
-				case 5:
-					return at(index.row())->ef_description();
-				}
-			}
-		}
+		m_session.reset(new odb::session(false));
 
-		return QVariant();
+		if (current)
+			odb::session::current_pointer(m_session.get());
 	}
 
-	int EditFilesTableModel::rowCount(const QModelIndex &parent) const
+	void EmulationSession::createUpdateConnections()
 	{
-		return size();
+		connect(emulation_dal::DB::notifier()->Emulation_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(eraseEmulation(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(eraseEmulation(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(eraseVariable(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(eraseVariable(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(eraseFile(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(eraseFile(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_runtime_request_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(eraseRuntimeRequest(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_runtime_request_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(eraseRuntimeRequest(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(eraseTopologyHost(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(eraseTopologyHost(const NotifyEvent &)));
 	}
 
-	int EditFilesTableModel::columnCount(const QModelIndex &parent) const
+	void EmulationSession::eraseEmulation(const NotifyEvent &ev)
 	{
-		return 6;
+		erase<emulation_dal::Emulation>(ev.objectId());
 	}
 
-	// ViewVariablesTableWidget
-	ViewVariablesTableWidget::ViewVariablesTableWidget(QWidget *parent)
-		: DBTableViewBase(parent)
+	void EmulationSession::eraseVariable(const NotifyEvent &ev)
 	{
-		setModel(new ViewVariablesTableModel(this));
+		erase<emulation_dal::Emulation_variable>(ev.objectId());
+	}
 
-		init();
+	void EmulationSession::eraseFile(const NotifyEvent &ev)
+	{
+		erase<emulation_dal::Emulation_file>(ev.objectId());
 	}
 
-	ViewVariablesTableWidget::ViewVariablesTableWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent)
-		: DBTableViewBase(parent)
+	void EmulationSession::eraseRuntimeRequest(const NotifyEvent &ev)
 	{
-		setModel(new ViewVariablesTableModel(value, this));
+		erase<emulation_dal::Emulation_runtime_request>(ev.objectId());
+	}
 
-		init();
+	void EmulationSession::eraseTopologyHost(const NotifyEvent &ev)
+	{
+		erase<emulation_dal::Emulation_topology_host>(ev.objectId());
 	}
 
-	void ViewVariablesTableWidget::init()
+	// EmulationSession::Scope
+	EmulationSession::Scope::Scope(const QObject *object)
+		: m_previous(odb::session::current_pointer()), m_active(false)
 	{
-		setSelectionBehavior(SelectRows);
+		auto session = EmulationSession::of(object);
 
-		if (isSettingsExist())
-			loadSettings();
+		if (session) {
+			odb::session::current_pointer(&session->session());
+			m_active = true;
+		}
+	}
 
-		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+	EmulationSession::Scope::~Scope()
+	{
+		if (m_active)
+			odb::session::current_pointer(m_previous);
+	}
 
-		enableGlobalActions();
+	// DBRowIndex
+	DBRowIndex::DBRowIndex(QAbstractItemModel *model)
+		: QObject(model), m_rowsCount(0), m_valid(false)
+	{
+		connect(model, SIGNAL(rowsInserted(const QModelIndex &, int, int)), SLOT(insertRows(const QModelIndex &, int, int)));
+		connect(model, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), SLOT(updateRows(const QModelIndex &, const QModelIndex &)));
+		connect(model, SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)), SLOT(eraseRows(const QModelIndex &, int, int)));
+		connect(model, SIGNAL(rowsRemoved(const QModelIndex &, int, int)), SLOT(shiftRows(const QModelIndex &, int, int)));
+		connect(model, SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)), SLOT(invalidate()));
+		connect(model, SIGNAL(modelReset()), SLOT(invalidate()));
+		connect(model, SIGNAL(layoutChanged()), SLOT(invalidate()));
+	}
 
+	void DBRowIndex::invalidate()
+	{
+		m_valid = false;
 	}
 
-	void ViewVariablesTableWidget::setDataVector(const emulation_dal::Emulation_variable_store &value)
+	void DBRowIndex::rebuild() const
 	{
-		auto variablesModel = model();
+		m_rows.clear();
+		m_rowsCount = recordsCount();
+		m_rows.reserve(m_rowsCount);
 
-		if (variablesModel)
-			variablesModel->setDataVector(value);
+		long id;
+
+		for (int row = 0; row < m_rowsCount; ++row) {
+			if (recordId(row, id))
+				m_rows.insert(id, row);
+		}
+
+		m_valid = true;
 	}
 
-	void ViewVariablesTableWidget::clearDataVector()
+	void DBRowIndex::insertRows(const QModelIndex &parent, int first, int last)
 	{
-		auto variablesModel = model();
+		if (m_valid && first == m_rowsCount) {
+			long id;
 
-		if (variablesModel)
-			variablesModel->clearDataVector();
+			for (int row = first; row <= last; ++row) {
+				if (recordId(row, id))
+					m_rows.insert(id, row);
+			}
+
+			m_rowsCount = last + 1;
+		}
+		else
+			invalidate();
 	}
 
-	// ViewVariablesWidget
-	ViewVariablesWidget::ViewVariablesWidget(QWidget* parent)
-		: QWidget(parent)
+	void DBRowIndex::updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 	{
-		m_table = new ViewVariablesTableWidget(this);
+		if (m_valid) {
+			long id;
 
-		init();
+			for (int row = topLeft.row(); row <= bottomRight.row() && row < m_rowsCount; ++row) {
+				if (recordId(row, id))
+					m_rows.insert(id, row);
+			}
+		}
 	}
 
-	ViewVariablesWidget::ViewVariablesWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent)
-		: QWidget(parent)
+	void DBRowIndex::eraseRows(const QModelIndex &parent, int first, int last)
 	{
-		m_table = new ViewVariablesTableWidget(value, this);
+		if (m_valid) {
+			long id;
 
-		init();
+			for (int row = first; row <= last && row < m_rowsCount; ++row) {
+				if (recordId(row, id) && m_rows.value(id, -1) == row)
+					m_rows.remove(id);
+			}
+		}
 	}
 
-	void ViewVariablesWidget::init()
+	void DBRowIndex::shiftRows(const QModelIndex &parent, int first, int last)
 	{
-		m_label = new QLabel(tr("Scenery variables: "));
+		if (!m_valid)
+			return;
 
-		m_layout = new QVBoxLayout();
-		m_layout->setContentsMargins(0, 0, 0, 0);
-		setLayout(m_layout);
+		if (last >= m_rowsCount) {
+			invalidate();
+			return;
+		}
 
-		m_layout->addWidget(m_label);
-		m_layout->addWidget(m_table);
+		const int count = last - first + 1;
+
+		//      
+		if (last < m_rowsCount - 1) {
+			for (auto it = m_rows.begin(); it != m_rows.end(); ++it) {
+				if (it.value() > last)
+					it.value() -= count;
+			}
+		}
 
+		m_rowsCount -= count;
 	}
 
-	void ViewVariablesWidget::tableData(const emulation_dal::Emulation_variable_store &value)
+	int DBRowIndex::row(const long id) const
 	{
-		m_table->setDataVector(value);
+		if (!m_valid)
+			rebuild();
+
+		auto it = m_rows.find(id);
+
+		if (it == m_rows.end())
+			return -1;
+
+		long rowId;
+
+		if (it.value() < recordsCount() && recordId(it.value(), rowId) && rowId == id)
+			return it.value();
+
+		rebuild();
+
+		return m_rows.value(id, -1);
 	}
 
-	ViewVariablesTableModel *ViewVariablesWidget::tableModel() const
+	bool DBRowIndex::contains(const long id) const
 	{
-		return m_table->model();
+		return row(id) >= 0;
 	}
 
-	void ViewVariablesWidget::clear()
+	// DBNameIndex
+	DBNameIndex::DBNameIndex(QAbstractItemModel *model)
+		: QObject(model), m_rowsCount(0), m_valid(false)
 	{
-		m_table->clearDataVector();
+		connect(model, SIGNAL(rowsInserted(const QModelIndex &, int, int)), SLOT(insertRows(const QModelIndex &, int, int)));
+		connect(model, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), SLOT(updateRows(const QModelIndex &, const QModelIndex &)));
+		connect(model, SIGNAL(rowsRemoved(const QModelIndex &, int, int)), SLOT(invalidate()));
+		connect(model, SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)), SLOT(invalidate()));
+		connect(model, SIGNAL(modelReset()), SLOT(invalidate()));
+		connect(model, SIGNAL(layoutChanged()), SLOT(invalidate()));
 	}
 
-	bool ViewVariablesWidget::appendById(const long id)
+	QString DBNameIndex::normalized(const QString &value)
 	{
-		return tableModel()->appendById(id);
+		return value.trimmed();
 	}
 
-	bool ViewVariablesWidget::updateById(const long id)
+	void DBNameIndex::invalidate()
 	{
-		return tableModel()->updateById(id);
+		m_valid = false;
 	}
 
-	bool ViewVariablesWidget::removeById(const long id)
+	void DBNameIndex::insertRow(const int row) const
 	{
-		return tableModel()->removeById(id);
+		auto name = normalized(recordName(row));
+
+		if (!name.isEmpty() && !m_rows.contains(name))
+			m_rows.insert(name, row);
 	}
 
-	// ViewFilesTableWidget
-	ViewFilesTableWidget::ViewFilesTableWidget(QWidget *parent)
-		: DBTableViewBase(parent)
+	void DBNameIndex::rebuild() const
 	{
-		setModel(new ViewFilesTableModel(this));
+		m_rows.clear();
+		m_rowsCount = recordsCount();
+		m_rows.reserve(m_rowsCount);
 
-		init();
+		for (int row = 0; row < m_rowsCount; ++row)
+			insertRow(row);
+
+		m_valid = true;
 	}
 
-	ViewFilesTableWidget::ViewFilesTableWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent)
-		: DBTableViewBase(parent)
+	void DBNameIndex::insertRows(const QModelIndex &parent, int first, int last)
 	{
-		setModel(new ViewFilesTableModel(value, this));
+		if (m_valid && first == m_rowsCount) {
+			for (int row = first; row <= last; ++row)
+				insertRow(row);
 
-		init();
+			m_rowsCount = last + 1;
+		}
+		else
+			invalidate();
 	}
 
-	void ViewFilesTableWidget::init()
+	void DBNameIndex::updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 	{
-		setSelectionBehavior(SelectRows);
+		if (m_valid) {
+			for (int row = topLeft.row(); row <= bottomRight.row() && row < m_rowsCount; ++row)
+				insertRow(row);
+		}
+	}
 
-		if (isSettingsExist())
-			loadSettings();
+	int DBNameIndex::row(const QString &name) const
+	{
+		if (!m_valid)
+			rebuild();
 
-		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+		auto key = normalized(name);
+		auto it = m_rows.find(key);
 
-		enableGlobalActions();
+		if (it == m_rows.end())
+			return -1;
 
-	}
+		if (it.value() < recordsCount() && normalized(recordName(it.value())) == key)
+			return it.value();
 
-	void ViewFilesTableWidget::setDataVector(const emulation_dal::Emulation_file_store &value)
-	{
-		auto filesModel = model();
+		rebuild();
 
-		if (filesModel)
-			filesModel->setDataVector(value);
+		return m_rows.value(key, -1);
 	}
 
-	void ViewFilesTableWidget::clearDataVector()
+	bool DBNameIndex::contains(const QString &name) const
 	{
-		auto filesModel = model();
-
-		if (filesModel)
-			filesModel->clearDataVector();
+		return row(name) >= 0;
 	}
 
-	// ViewFilesWidget
-	ViewFilesWidget::ViewFilesWidget(QWidget* parent)
-		: QWidget(parent)
+	// PayloadPreview
+	QString PayloadPreview::text(const QByteArray &value, const int length)
 	{
-		m_table = new ViewFilesTableWidget(this);
-
-		init();
+		return prefixText(value.left(length), value.size(), length);
 	}
 
-	ViewFilesWidget::ViewFilesWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent)
-		: QWidget(parent)
+	QString PayloadPreview::prefixText(const QByteArray &prefix, const qint64 size, const int length)
 	{
-		m_table = new ViewFilesTableWidget(value, this);
+		if (size <= 0)
+			return QString();
 
-		init();
-	}
-
-	void ViewFilesWidget::init()
-	{
-		m_label = new QLabel(tr("Scenery files: "));
+		auto fragment = prefix.left(length);
 
-		m_useFileStoreLabel = new QLabel();
+		QString result;
 
-		m_layout = new QVBoxLayout();
-		m_layout->setContentsMargins(0, 0, 0, 0);
-		setLayout(m_layout);
+		if (isBinary(fragment))
+			result = QString::fromLatin1(fragment.left(length / 4).toHex(' '));
+		else
+			result = QString::fromUtf8(fragment).simplified();
 
-		m_layout->addWidget(m_label);
-		m_layout->addWidget(m_useFileStoreLabel);
-		m_layout->addWidget(m_table);
+		if (size > fragment.size())
+			result += QChar(0x2026);
 
+		return QString("[%1] %2").arg(PayloadPreview::size(size), result);
 	}
 
-	void ViewFilesWidget::tableData(const emulation_dal::Emulation_file_store &value)
+	QString PayloadPreview::size(const qint64 value)
 	{
-		m_table->setDataVector(value);
+		return QLocale().formattedDataSize(value);
 	}
 
-	ViewFilesTableModel *ViewFilesWidget::tableModel() const
+	QString PayloadPreview::toolTip(const qint64 size, const QString &md5)
 	{
-		return m_table->model();
-	}
+		if (md5.isEmpty())
+			return QObject::tr("Size: ") + PayloadPreview::size(size);
 
-	void ViewFilesWidget::clear()
-	{
-		m_table->clearDataVector();
+		return QObject::tr("Size: ") + PayloadPreview::size(size) + "\n" + QObject::tr("MD5: ") + md5;
 	}
 
-	void ViewFilesWidget::useFileStore(const bool value, const QString path)
+	bool PayloadPreview::isBinary(const QByteArray &value)
 	{
-		if (value) {
-			auto trimmedPath = path.trimmed();
-
-			if (trimmedPath.isEmpty()) {
-				m_useFileStoreLabel->setText(tr("Use file store"));
-
-			}
-			else {
-				m_useFileStoreLabel->setText(tr("Use file store, path: ") + trimmedPath);
-
-			}
+		for (auto c : value) {
+			auto code = static_cast<unsigned char>(c);
 
+			if (code == 0 || (code < 0x20 && c != '\t' && c != '\n' && c != '\r'))
+				return true;
 		}
-		else
-			m_useFileStoreLabel->setText(tr("Dont use file store"));
 
+		return false;
 	}
 
-	bool ViewFilesWidget::appendById(const long id)
+	// EmulationFileStore
+	qint64 EmulationFileStore::Usage::savedSize() const
 	{
-		return tableModel()->appendById(id);
+		return referencedSize - storedSize;
 	}
 
-	bool ViewFilesWidget::updateById(const long id)
+	EmulationFileStore::EmulationFileStore(const QString &root)
+		: m_root(root.trimmed())
 	{
-		return tableModel()->updateById(id);
 	}
 
-	bool ViewFilesWidget::removeById(const long id)
+	QString EmulationFileStore::root() const
 	{
-		return tableModel()->removeById(id);
+		return m_root;
 	}
 
-	// EditFilesVariablesTableWidgetBase
-	EditFilesVariablesTableWidgetBase::EditFilesVariablesTableWidgetBase(QWidget *parent)
-		: DBTableViewBase(parent)
+	bool EmulationFileStore::isValid() const
 	{
-		init();
+		return !m_root.isEmpty();
 	}
 
-	void EditFilesVariablesTableWidgetBase::init()
+	QString EmulationFileStore::path(const QString &hash) const
 	{
-		connect(this, SIGNAL(selectionChanged(const QModelIndex)), SLOT(enableGlobalActions()));
+		return QString("%1/objects/%2/%3").arg(m_root, hash.left(2), hash);
 	}
 
-	void EditFilesVariablesTableWidgetBase::enableGlobalActions()
+	bool EmulationFileStore::contains(const QString &hash) const
 	{
-		enableNewAction();
-
-		if (currentIndex().isValid()) {
-			enableOpenAction();
-			enableDeleteAction();
-		}
+		return isValid() && !hash.isEmpty() && QFileInfo::exists(path(hash));
 	}
 
-	// EditFilesVariablesWidgetBase
-	EditFilesVariablesWidgetBase::EditFilesVariablesWidgetBase(QWidget* parent)
-		: QWidget(parent)
+	qint64 EmulationFileStore::size(const QString &hash) const
 	{
-		init();
+		QFileInfo info(path(hash));
+
+		return isValid() && info.exists() ? info.size() : -1;
 	}
 
-	void EditFilesVariablesWidgetBase::init()
+	QString EmulationFileStore::put(const QByteArray &data) const
 	{
-		m_toolbar = new NERToolbar(tr("Edit variables toolbar"));
+		if (!isValid())
+			return QString();
 
-		m_label = new QLabel();
+		auto hash = QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
 
-		m_layout = new QVBoxLayout();
-		m_layout->setContentsMargins(0, 0, 0, 0);
-		setLayout(m_layout);
+		//       .     , 
+		//   ,    
+		{
+			auto existing = map(hash);
 
-		QHBoxLayout *labelLayout = new QHBoxLayout();
+			if (existing && existing->size() == data.size() && memcmp(existing->data(), data.constData(), data.size()) == 0)
+				return hash;
+		}
 
-		labelLayout->addWidget(m_label);
-		labelLayout->addStretch();
-		labelLayout->addWidget(m_toolbar);
+		if (!QDir().mkpath(QFileInfo(path(hash)).absolutePath()))
+			return QString();
 
-		m_layout->addLayout(labelLayout);
+		QSaveFile file(path(hash));
 
-		int buttonsHeight = m_label->fontMetrics().height();
+		if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+			return QString();
 
-		if (buttonsHeight > 0)
-			m_toolbar->setIconSize(QSize(buttonsHeight, buttonsHeight));
+		return hash;
+	}
 
+	QByteArray EmulationFileStore::get(const QString &hash) const
+	{
+		auto mapping = map(hash);
+
+		if (!mapping || mapping->size() > std::numeric_limits<int>::max())
+			return QByteArray();
+
+		return QByteArray(mapping->data(), static_cast<int>(mapping->size()));
 	}
 
-	void EditFilesVariablesWidgetBase::updateControlsAccesibility()
+	std::shared_ptr<const EmulationFileMapping> EmulationFileStore::map(const QString &hash) const
 	{
-		if (m_table) {
-			if (m_table->currentIndex().isValid())
-			{
-				m_toolbar->editAction()->setEnabled(true);
-				m_toolbar->removeAction()->setEnabled(true);
+		if (!isValid() || hash.isEmpty())
+			return nullptr;
+
+		return EmulationFileMapping::open(path(hash));
+	}
+
+	EmulationFileStore::Usage EmulationFileStore::usage(const QStringList &hashes) const
+	{
+		Usage result;
+		QHash<QString, qint64> sizes;
+
+		for (auto &i : hashes) {
+			auto it = sizes.find(i);
 
+			if (it == sizes.end()) {
+				it = sizes.insert(i, size(i));
+
+				if (it.value() >= 0) {
+					++result.objects;
+					result.storedSize += it.value();
+				}
 			}
-			else {
-				m_toolbar->editAction()->setEnabled(false);
-				m_toolbar->removeAction()->setEnabled(false);
 
+			if (it.value() >= 0) {
+				++result.references;
+				result.referencedSize += it.value();
 			}
 		}
-		else
-			m_toolbar->disableAllActions();
 
+		return result;
 	}
 
-	EditFilesVariablesTableWidgetBase *EditFilesVariablesWidgetBase::tableWidget() const
+	QByteArray EmulationFileStore::reference(const QString &hash)
 	{
-		return m_table;
+		return "sha256:" + hash.toLatin1();
+	}
 
+	bool EmulationFileStore::isReference(const QByteArray &data)
+	{
+		static const QRegularExpression pattern("^sha256:[0-9a-f]{64}$");
+
+		return data.size() == ReferenceLength && pattern.match(QString::fromLatin1(data)).hasMatch();
 	}
 
-	void EditFilesVariablesWidgetBase::setTableWidget(EditFilesVariablesTableWidgetBase *value)
+	QString EmulationFileStore::hash(const QByteArray &reference)
 	{
-		if (!m_table) {
-			m_table = value;
+		return isReference(reference) ? QString::fromLatin1(reference.mid(7)) : QString();
+	}
 
-			m_layout->addWidget(m_table);
+	QStringList EmulationFileStore::references() const
+	{
+		typedef odb::query<EmulationFileReference> query;
 
-			connect(m_table, SIGNAL(selectionChanged(const QModelIndex)), SLOT(updateControlsAccesibility()));
+		QStringList result;
 
-			updateControlsAccesibility();
+		if (!isValid())
+			return result;
+
+		try {
+			odb::transaction transaction(emulation_dal::DB::database()->begin());
+
+			odb::result<EmulationFileReference> rows(transaction.database().query<EmulationFileReference>(
+				query("trim(e.emulation_file_store_path) =") + query::_val(m_root)));
+
+			for (auto it = rows.begin(); it != rows.end(); ++it) {
+				if (isReference(it->reference))
+					result << hash(it->reference);
+			}
+
+			transaction.commit();
+		}
+		catch (const odb::exception &) {
+			result.clear();
 		}
-		else
-			throw std::exception();
 
+		return result;
 	}
 
-	// EditVariablesTableWidget
-	EditVariablesTableWidget::EditVariablesTableWidget(QWidget *parent)
-		: EditFilesVariablesTableWidgetBase(parent)
+	// EmulationFileMapping
+	EmulationFileMapping::EmulationFileMapping(const QString &path)
+		: m_file(path), m_data(nullptr), m_size(0)
 	{
-		init();
 	}
 
-	EditVariablesTableWidget::EditVariablesTableWidget(const std::shared_ptr<emulation_dal::Emulation> emulationData, QWidget *parent)
-		: EditFilesVariablesTableWidgetBase(parent)
+	EmulationFileMapping::~EmulationFileMapping()
 	{
-		init();
+		if (m_data)
+			m_file.unmap(m_data);
+	}
 
-		if (emulationData)
-			setDataVector(*emulationData->emulation_variables());
+	std::shared_ptr<const EmulationFileMapping> EmulationFileMapping::open(const QString &path)
+	{
+		auto key = QFileInfo(path).absoluteFilePath();
+
+		QMutexLocker locker(&registryMutex());
+
+		auto it = registry().find(key);
+
+		if (it != registry().end()) {
+			if (auto mapping = it.value().lock())
+				return mapping;
+		}
+
+		std::shared_ptr<EmulationFileMapping> mapping(new EmulationFileMapping(key));
+
+		if (!mapping->m_file.open(QIODevice::ReadOnly))
+			return nullptr;
+
+		mapping->m_size = mapping->m_file.size();
+
+		if (mapping->m_size > 0) {
+			mapping->m_data = mapping->m_file.map(0, mapping->m_size);
+
+			if (!mapping->m_data)
+				return nullptr;
+		}
+
+		//     ,   
+		mapping->m_file.close();
 
+		for (auto i = registry().begin(); i != registry().end();) {
+			if (i.value().expired())
+				i = registry().erase(i);
+			else
+				++i;
+		}
+
+		registry().insert(key, mapping);
+
+		return mapping;
 	}
 
-	void EditVariablesTableWidget::init()
+	QString EmulationFileMapping::path() const
 	{
-		setModel(new EditVariablesTableModel(this));
+		return m_file.fileName();
+	}
 
-		setItemDelegateForColumn(1, new VariableTypesListDelegate(this));
-		setItemDelegateForColumn(2, new VariableLenghtDelegate(this));
+	const char *EmulationFileMapping::data() const
+	{
+		return reinterpret_cast<const char *>(m_data);
+	}
 
-		setSelectionBehavior(SelectRows);
+	qint64 EmulationFileMapping::size() const
+	{
+		return m_size;
+	}
 
-		if (isSettingsExist())
-			loadSettings();
+	QByteArray EmulationFileMapping::bytes() const
+	{
+		//  QByteArray  int,      
+		return QByteArray::fromRawData(data(), static_cast<int>(std::min<qint64>(m_size, std::numeric_limits<int>::max())));
+	}
 
-		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+	int EmulationFileMapping::count()
+	{
+		QMutexLocker locker(&registryMutex());
 
-		enableGlobalActions();
+		int result = 0;
+
+		for (auto &i : registry()) {
+			if (!i.expired())
+				++result;
+		}
 
+		return result;
 	}
 
-	void EditVariablesTableWidget::setDataVector(const emulation_dal::Emulation_variable_store &value)
+	QHash<QString, std::weak_ptr<const EmulationFileMapping>> &EmulationFileMapping::registry()
 	{
-		auto variablesModel = model();
+		static QHash<QString, std::weak_ptr<const EmulationFileMapping>> value;
 
-		if (variablesModel)
-			variablesModel->setDataVector(value);
+		return value;
 	}
 
-	const emulation_dal::Emulation_variable_store &EditVariablesTableWidget::dataVector() const
+	QMutex &EmulationFileMapping::registryMutex()
 	{
-		return *model();
+		static QMutex mutex;
+
+		return mutex;
 	}
 
-	void EditVariablesTableWidget::clearDataVector()
+	// EmulationFileCodec
+	const char EmulationFileCodec::Magic[] = "\x89" "EFZ";
+
+	EmulationFileCodec::Decoder::Decoder(QIODevice *target)
+		: m_target(target), m_state(Detect), m_size(0), m_written(0)
 	{
-		auto variablesModel = model();
+	}
 
-		if (variablesModel)
-			variablesModel->clearDataVector();
+	bool EmulationFileCodec::Decoder::write(const char *data, const qint64 length)
+	{
+		m_buffer.append(data, static_cast<int>(length));
+
+		return process();
 	}
 
-	void EditVariablesTableWidget::newVariableDialog()
+	bool EmulationFileCodec::Decoder::finish()
 	{
-		EditVariablesDialog *dialog = new EditVariablesDialog(this);
+		if (m_state == Detect) {
+			m_state = Raw;
 
-		if (dialog->exec() == QDialog::Accepted) {
-			auto data = dialog->dbData();
+			return process();
+		}
 
-			if (data) {
+		return m_state == Raw || (m_buffer.isEmpty() && m_written == m_size);
+	}
 
-				auto variablesModel = model();
+	bool EmulationFileCodec::Decoder::process()
+	{
+		if (m_state == Detect) {
+			if (m_buffer.size() < HeaderLength)
+				return true;
 
-				if (variablesModel) {
-					for (auto i : *variablesModel) {
-						if (i && i->ev_name().trimmed() == data->ev_name().trimmed()) {
-							Global::Messages::ErrorMessage(tr("Variable name ") + data->ev_name().trimmed() + tr(" is already exist!"));
-							return;
-						}
+			if (hasHeader(m_buffer)) {
+				m_size = qFromBigEndian<qint64>(reinterpret_cast<const uchar *>(m_buffer.constData() + 5));
+				m_buffer.remove(0, HeaderLength);
+				m_state = Blocks;
+			}
+			else
+				m_state = Raw;
+		}
 
-					}
+		if (m_state == Raw) {
+			bool result = m_target->write(m_buffer) == m_buffer.size();
+			m_buffer.clear();
 
-					variablesModel->push_back(data);
-					emit addVariableSignal(data->ev_name());
+			return result;
+		}
 
-				}
+		int offset = 0;
 
-			}
+		while (m_buffer.size() - offset >= 4) {
+			auto blockHeader = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(m_buffer.constData() + offset));
+			int length = static_cast<int>(blockHeader & ~RawBlockFlag);
+
+			if (m_buffer.size() - offset - 4 < length)
+				break;
+
+			auto blockData = m_buffer.constData() + offset + 4;
+			auto block = blockHeader & RawBlockFlag ? QByteArray::fromRawData(blockData, length)
+				: qUncompress(reinterpret_cast<const uchar *>(blockData), length);
 
+			if (block.isEmpty() || m_target->write(block) != block.size())
+				return false;
+
+			m_written += block.size();
+			offset += 4 + length;
 		}
 
+		m_buffer.remove(0, offset);
+
+		return m_written <= m_size;
 	}
 
-	void EditVariablesTableWidget::editVariableDialog(const QString &value)
+	EmulationFileCodec::Codec EmulationFileCodec::codec(const std::shared_ptr<emulation_dal::Emulation_file_type> &type)
 	{
-		auto it = model()->find_by_attribute(emulation_dal::Emulation_variable::Attributes::EV_NAME, value);
-
-		if (it != model()->end()) {
-			auto lastData = *it;
+		static const QHash<QString, Codec> codecs {
+			{ "configuration", Zlib },
+			{ "script", Zlib },
+			{ "log", Zlib },
+			{ "text", Zlib },
+			{ "xml", Zlib },
+			{ "json", Zlib },
+			{ "yaml", Zlib },
+			{ "csv", Zlib },
+			{ "html", Zlib }
+		};
 
-			if (lastData) {
-				QString lastName = lastData->ev_name();
+		return type ? codecs.value(type->eft_name().trimmed().toLower(), None) : None;
+	}
 
-				EditVariablesDialog *dialog = new EditVariablesDialog(lastData, this);
+	QByteArray EmulationFileCodec::data(const emulation_dal::Emulation_file &file)
+	{
+		return decode(file.ef_data());
+	}
 
-				if (dialog->exec() == QDialog::Accepted) {
+	void EmulationFileCodec::setData(emulation_dal::Emulation_file &file, const QByteArray &storedData)
+	{
+		file.ef_data(storedData);
+	}
 
-					auto newData = dialog->dbData();
+	EmulationFileCodec::Codec EmulationFileCodec::codec(const QByteArray &data)
+	{
+		return hasHeader(data) ? static_cast<Codec>(data.at(4)) : None;
+	}
 
-					if (newData) {
+	QByteArray EmulationFileCodec::encode(const QByteArray &data, const Codec codec, const Progress &progress,
+		const std::shared_ptr<QAtomicInt> &cancelFlag)
+	{
+		if (codec == None || data.size() <= HeadLength)
+			return data;
 
-						auto variablesModel = model();
+		QByteArray result(HeaderLength, Qt::Uninitialized);
+		memcpy(result.data(), Magic, 4);
+		result[4] = static_cast<char>(codec);
+		qToBigEndian<qint64>(data.size(), reinterpret_cast<uchar *>(result.data() + 5));
 
-						auto newName = newData->ev_name();
+		auto appendBlock = [&result](const QByteArray &block, const quint32 flags) {
+			uchar blockHeader[4];
+			qToBigEndian<quint32>(static_cast<quint32>(block.size()) | flags, blockHeader);
 
-						if (variablesModel) {
-							for (auto i : *variablesModel) {
-								if (i && i != newData && i->ev_name().trimmed() == newData->ev_name().trimmed()) {
-									newData->ev_name(lastName);
-									Global::Messages::ErrorMessage(tr("Variable name ") + newName.trimmed() + tr(" is already exist!"));
-									return;
-								}
-							}
+			result.append(reinterpret_cast<const char *>(blockHeader), 4);
+			result.append(block);
+		};
 
-							variablesModel->at(it, newData);
-							emit editVariableSignal(lastName, newName);
+		appendBlock(data.left(HeadLength), RawBlockFlag);
 
-						}
+		for (int offset = HeadLength; offset < data.size(); offset += BlockLength) {
+			if (cancelFlag && cancelFlag->load())
+				return data;
 
-					}
+			auto length = std::min(data.size() - offset, int(BlockLength));
+			auto block = qCompress(reinterpret_cast<const uchar *>(data.constData() + offset), length);
 
-				}
+			if (block.size() < length)
+				appendBlock(block, 0);
+			else
+				appendBlock(QByteArray::fromRawData(data.constData() + offset, length), RawBlockFlag);
 
-			}
+			if (result.size() >= data.size())
+				return data;
 
+			if (progress)
+				progress(offset + length, data.size());
 		}
 
+		return result;
 	}
 
-	void EditVariablesTableWidget::removeVariable(const QString &value)
-	{		
-		auto it = model()->find_by_attribute(emulation_dal::Emulation_variable::Attributes::EV_NAME, value);
+	QByteArray EmulationFileCodec::decode(const QByteArray &data)
+	{
+		if (codec(data) == None)
+			return data;
 
-		if (it != model()->end() && *it) {
-			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
+		QByteArray result;
+		result.reserve(static_cast<int>(size(data, data.size())));
 
-				auto deletedName = (*it)->ev_name();
+		QBuffer target(&result);
+		target.open(QIODevice::WriteOnly);
 
-				model()->removeRow(it);
+		Decoder decoder(&target);
 
-				emit deleteVariableSignal(deletedName);
-			}
+		if (!decoder.write(data.constData(), data.size()) || !decoder.finish())
+			return QByteArray();
 
-		}
-		
+		return result;
 	}
 
-	
-	void EditVariablesTableWidget::onNewAction()
+	qint64 EmulationFileCodec::size(const QByteArray &prefix, const qint64 storedSize)
 	{
-		newVariableDialog();
+		return hasHeader(prefix) ? qFromBigEndian<qint64>(reinterpret_cast<const uchar *>(prefix.constData() + 5)) : storedSize;
 	}
 
-	void EditVariablesTableWidget::onOpenAction()
+	QByteArray EmulationFileCodec::head(const QByteArray &prefix)
 	{
-		QModelIndex idx = currentIndex();
+		if (!hasHeader(prefix))
+			return prefix;
 
-		if (idx.isValid()) {
+		if (prefix.size() < HeaderLength + 4)
+			return QByteArray();
 
-			auto lastData = model()->at(idx.row());
+		auto blockHeader = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(prefix.constData() + HeaderLength));
 
-			if (lastData) {
+		if (!(blockHeader & RawBlockFlag))
+			return QByteArray();
 
-				QString lastName = lastData->ev_name();
+		return prefix.mid(HeaderLength + 4, static_cast<int>(blockHeader & ~RawBlockFlag));
+	}
 
-				EditVariablesDialog *dialog = new EditVariablesDialog(lastData, this);
+	bool EmulationFileCodec::hasHeader(const QByteArray &data)
+	{
+		return data.size() >= HeaderLength && memcmp(data.constData(), Magic, 4) == 0 && data.at(4) == Zlib;
+	}
 
-				if (dialog->exec() == QDialog::Accepted) {
+	// EmulationFileTransfer
+	EmulationFileTransfer::EmulationFileTransfer(QProgressDialog *dialog)
+		: QObject(dialog), m_dialog(dialog), m_cancelFlag(std::make_shared<QAtomicInt>(0))
+	{
+		connect(this, SIGNAL(progress(qint64, qint64)), SLOT(updateProgress(qint64, qint64)));
+		connect(dialog, SIGNAL(canceled()), SLOT(cancel()));
+	}
 
-					auto newData = dialog->dbData();
+	bool EmulationFileTransfer::isCanceled(const std::shared_ptr<QAtomicInt> &cancelFlag)
+	{
+		return cancelFlag && cancelFlag->load();
+	}
 
-					if (newData) {
+	bool EmulationFileTransfer::copy(QIODevice *source, QIODevice *target, const qint64 total, const Progress &progress,
+		const std::shared_ptr<QAtomicInt> &cancelFlag, QCryptographicHash *hash)
+	{
+		QByteArray buffer(static_cast<int>(ChunkSize), Qt::Uninitialized);
+		qint64 done = 0;
 
-						auto variablesModel = model();
+		for (;;) {
+			if (isCanceled(cancelFlag))
+				return false;
 
-						auto newName = newData->ev_name();
+			auto length = source->read(buffer.data(), buffer.size());
 
-						if (variablesModel) {
-							for (auto i : *variablesModel) {
-								if (i && i != newData && i->ev_name().trimmed() == newData->ev_name().trimmed()) {
-									newData->ev_name(lastName);
-									Global::Messages::ErrorMessage(tr("Variable name ") + newName.trimmed() + tr(" is already exist!"));
-									return;
-								}
-							}
+			if (length < 0)
+				return false;
 
-							variablesModel->at(idx.row(), newData);
-							emit editVariableSignal(lastName, newName);
+			if (length == 0)
+				break;
 
-						}
+			if (hash)
+				hash->addData(buffer.constData(), static_cast<int>(length));
 
-					}
+			if (target->write(buffer.constData(), length) != length)
+				return false;
 
-				}
+			done += length;
 
-			}
+			if (progress)
+				progress(done, total);
+		}
+
+		return true;
+	}
+
+	bool EmulationFileTransfer::readObject(const EmulationFileStore &store, const QString &hash, QIODevice *target, const Progress &progress,
+		const std::shared_ptr<QAtomicInt> &cancelFlag)
+	{
+		auto mapping = store.map(hash);
+
+		if (!mapping)
+			return false;
 
+		for (qint64 offset = 0; offset < mapping->size(); offset += ChunkSize) {
+			if (isCanceled(cancelFlag))
+				return false;
+
+			auto length = std::min(mapping->size() - offset, qint64(ChunkSize));
+
+			if (target->write(mapping->data() + offset, length) != length)
+				return false;
+
+			if (progress)
+				progress(offset + length, mapping->size());
 		}
 
+		return true;
 	}
 
-	void EditVariablesTableWidget::onDeleteAction()
+	bool EmulationFileTransfer::read(const long fileId, const EmulationFileStore &store, QIODevice *target, const Progress &progress,
+		const std::shared_ptr<QAtomicInt> &cancelFlag)
 	{
-		QModelIndex idx = currentIndex();
+		auto row = QueryByIdCache<EmulationFileRowStore>::fetch(fileId);
 
-		if (idx.isValid()) {
+		if (!row || !target)
+			return false;
 
-			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
-				auto variablesModel = model();
+		if (row->useFileStore && row->dataSize == EmulationFileStore::ReferenceLength && EmulationFileStore::isReference(row->dataPrefix))
+			return readObject(store, EmulationFileStore::hash(row->dataPrefix), target, progress, cancelFlag);
 
-				if (variablesModel) {
+		typedef odb::query<EmulationFileChunk> query;
 
-					auto deletedRec = variablesModel->at(idx.row());
+		EmulationFileCodec::Decoder decoder(target);
 
-					variablesModel->removeRow(idx.row());
+		try {
+			odb::transaction transaction(emulation_dal::DB::database()->begin());
 
-					if (deletedRec) {
+			for (qint64 offset = 0; offset < row->dataSize; offset += ChunkSize) {
+				if (isCanceled(cancelFlag))
+					return false;
 
-						emit deleteVariableSignal(deletedRec->ev_name());
+				odb::result<EmulationFileChunk> chunks(transaction.database().query<EmulationFileChunk>(
+					query("f.id =") + query::_val(fileId) + "AND s.first =" + query::_val(offset + 1)));
 
-					}
+				auto it = chunks.begin();
 
-				}
+				if (it == chunks.end() || !decoder.write(it->data.constData(), it->data.size()))
+					return false;
 
+				if (progress)
+					progress(std::min(offset + ChunkSize, row->dataSize), row->dataSize);
 			}
 
+			transaction.commit();
+		}
+		catch (const odb::exception &) {
+			return false;
 		}
 
+		return decoder.finish();
 	}
 
-	void EditVariablesTableWidget::contextMenuEvent(QContextMenuEvent *e)
+	bool EmulationFileTransfer::read(const std::shared_ptr<emulation_dal::Emulation_file> &file, const EmulationFileStore &store, QIODevice *target,
+		const Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag)
 	{
-		QTableView::contextMenuEvent(e);
+		if (!file || !target)
+			return false;
 
-		QModelIndex cur = currentIndex();
+		if (file->ef_use_file_store() && EmulationFileStore::isReference(file->ef_data()))
+			return readObject(store, EmulationFileStore::hash(file->ef_data()), target, progress, cancelFlag);
 
-		QMenu contextMenu(tr("Context Menu"));
+		const QByteArray &data = file->ef_data();
+		EmulationFileCodec::Decoder decoder(target);
 
-		QAction *createAction = contextMenu.addAction(tr("New"));
-		QAction *editAction = contextMenu.addAction(tr("Edit"));
-		contextMenu.addSeparator();
-		QAction *deleteAction = contextMenu.addAction(tr("Delete"));
+		for (qint64 offset = 0; offset < data.size(); offset += ChunkSize) {
+			if (isCanceled(cancelFlag))
+				return false;
 
-		if (!cur.isValid()) {
-			editAction->setDisabled(true);
-			deleteAction->setDisabled(true);
-		}
+			auto length = std::min(data.size() - offset, qint64(ChunkSize));
 
-		QAction *selectedAction = contextMenu.exec(e->globalPos());
+			if (!decoder.write(data.constData() + offset, length))
+				return false;
 
-		if (selectedAction == createAction)
-			onNewAction();
-		else if (selectedAction == editAction)
-			onOpenAction();
-		else if (selectedAction == deleteAction)
-			onDeleteAction();
+			if (progress)
+				progress(offset + length, data.size());
+		}
 
+		return decoder.finish();
 	}
 
-	// EditVariablesWidget
-	EditVariablesWidget::EditVariablesWidget(QWidget* parent)
-		: EditFilesVariablesWidgetBase(parent)
+	QString EmulationFileTransfer::writeToStore(const EmulationFileStore &store, QIODevice *source, const Progress &progress,
+		const std::shared_ptr<QAtomicInt> &cancelFlag)
 	{
-		init();
-	}
+		if (!store.isValid() || !source || !QDir().mkpath(store.root() + "/objects"))
+			return QString();
 
-	EditVariablesWidget::EditVariablesWidget(const std::shared_ptr<emulation_dal::Emulation> data, QWidget* parent)
-		: EditFilesVariablesWidgetBase(parent)
-	{
-		init();
+		QTemporaryFile file(store.root() + "/objects/transfer-XXXXXX");
+		QCryptographicHash hash(QCryptographicHash::Sha256);
 
-		loadDBData(data);
-	}
+		if (!file.open() || !copy(source, &file, source->size(), progress, cancelFlag, &hash) || !file.flush())
+			return QString();
 
-	void EditVariablesWidget::init()
-	{
-		EditFilesVariablesWidgetBase::setTableWidget(new EditVariablesTableWidget(this));
+		auto result = QString::fromLatin1(hash.result().toHex());
 
-		m_label->setText(tr("Scenery variables: "));
+		if (isStored(store, result, file))
+			return result;
 
-		connect(m_toolbar->newAction(), SIGNAL(triggered(bool)), SLOT(onNewAction()));
-		connect(m_toolbar->editAction(), SIGNAL(triggered(bool)), SLOT(onOpenAction()));
-		connect(m_toolbar->removeAction(), SIGNAL(triggered(bool)), SLOT(onDeleteAction()));
+		if (!QDir().mkpath(QFileInfo(store.path(result)).absolutePath()))
+			return QString();
 
-		connect(table(), SIGNAL(addVariableSignal(const QString &)), SIGNAL(addVariableSignal(const QString &)));
-		connect(table(), SIGNAL(editVariableSignal(const QString &, const QString &)), SIGNAL(editVariableSignal(const QString &, const QString &)));
-		connect(table(), SIGNAL(deleteVariableSignal(const QString &)), SIGNAL(deleteVariableSignal(const QString &)));
-	}
+		if (!store.contains(result)) {
+			file.close();
 
-	EditVariablesTableWidget *EditVariablesWidget::table() const
-	{
-		return dynamic_cast<EditVariablesTableWidget *>(EditFilesVariablesWidgetBase::tableWidget());
-	}
+			if (file.rename(store.path(result))) {
+				file.setAutoRemove(false);
+				return result;
+			}
 
-	void EditVariablesWidget::tableData(const emulation_dal::Emulation_variable_store &value)
-	{
-		table()->setDataVector(value);
-	}
+			if (!file.open())
+				return QString();
 
-	const emulation_dal::Emulation_variable_store &EditVariablesWidget::tableData() const
-	{
-		return table()->dataVector();
-	}
+			if (isStored(store, result, file))
+				return result;
+		}
 
-	EditVariablesTableModel *EditVariablesWidget::tableModel() const
-	{
-		return table()->model();
+		//    ,   EmulationFileStore::put
+		QSaveFile target(store.path(result));
+
+		if (!file.seek(0) || !target.open(QIODevice::WriteOnly) || !copy(&file, &target, file.size(), Progress(), cancelFlag) || !target.commit())
+			return QString();
+
+		return result;
 	}
 
-	void EditVariablesWidget::clear()
+	bool EmulationFileTransfer::isStored(const EmulationFileStore &store, const QString &hash, QFile &file)
 	{
-		table()->clearDataVector();
+		auto existing = store.map(hash);
+
+		if (!existing || existing->size() != file.size())
+			return false;
+
+		if (file.size() == 0)
+			return true;
+
+		auto data = file.map(0, file.size());
+
+		if (!data)
+			return false;
+
+		bool result = memcmp(existing->data(), data, static_cast<size_t>(file.size())) == 0;
+
+		file.unmap(data);
+
+		return result;
 	}
 
-	void EditVariablesWidget::onNewAction()
+	bool EmulationFileTransfer::readDevice(QIODevice *source, QByteArray &target, const Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag)
 	{
-		table()->onNewAction();
+		if (!source || source->size() > MaxDatabasePayload)
+			return false;
+
+		target.clear();
+		target.reserve(static_cast<int>(source->size()));
+
+		QBuffer buffer(&target);
+
+		return buffer.open(QIODevice::WriteOnly) && copy(source, &buffer, source->size(), progress, cancelFlag);
 	}
 
-	void EditVariablesWidget::onOpenAction()
+	bool EmulationFileTransfer::exec(QWidget *parent, const QString &label, const Job &job)
 	{
-		table()->onOpenAction();
+		QProgressDialog dialog(label, tr("Cancel"), 0, 1000, parent);
+		dialog.setWindowModality(Qt::WindowModal);
+		dialog.setMinimumDuration(500);
+		dialog.setAutoReset(false);
+
+		auto transfer = new EmulationFileTransfer(&dialog);
+		auto cancelFlag = transfer->m_cancelFlag;
+
+		QFutureWatcher<bool> watcher;
+		QEventLoop loop;
+
+		connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+
+		watcher.setFuture(QtConcurrent::run([job, transfer, cancelFlag]() {
+			return job([transfer](const qint64 done, const qint64 total) { emit transfer->progress(done, total); }, cancelFlag);
+		}));
+
+		loop.exec();
+
+		bool result = watcher.result() && !cancelFlag->load();
+
+		if (!result && !cancelFlag->load())
+			Global::Messages::ErrorMessage(tr("File transfer failed"));
+
+		return result;
 	}
 
-	void EditVariablesWidget::onDeleteAction()
+	void EmulationFileTransfer::updateProgress(qint64 done, qint64 total)
 	{
-		table()->onDeleteAction();
+		m_dialog->setValue(total > 0 ? static_cast<int>(done * 1000 / total) : 0);
 	}
 
-	void EditVariablesWidget::newVariableDialog()
+	void EmulationFileTransfer::cancel()
 	{
-		table()->newVariableDialog();
+		m_cancelFlag->store(1);
 	}
 
-	void EditVariablesWidget::editVariableDialog(const QString &value)
+	// EmulationFileStoreVerifier
+	EmulationFileStoreVerifier::Throttle::Throttle(const qint64 bytesPerSecond)
+		: m_bytes(0), m_bytesPerSecond(bytesPerSecond)
 	{
-		table()->editVariableDialog(value);
+		m_timer.start();
 	}
 
-	void EditVariablesWidget::removeVariable(const QString &value)
+	void EmulationFileStoreVerifier::Throttle::acquire(const qint64 bytes)
 	{
-		table()->removeVariable(value);
+		qint64 delay = 0;
+
+		{
+			QMutexLocker locker(&m_mutex);
+
+			if (m_timer.elapsed() - m_bytes * 1000 / m_bytesPerSecond > 1000) {
+				m_timer.restart();
+				m_bytes = 0;
+			}
+
+			m_bytes += bytes;
+			delay = m_bytes * 1000 / m_bytesPerSecond - m_timer.elapsed();
+		}
+
+		if (delay > 0)
+			QThread::msleep(static_cast<unsigned long>(delay));
 	}
 
-	void EditVariablesWidget::loadDBData(const std::shared_ptr<emulation_dal::Emulation> data)
+	EmulationFileStoreVerifier::EmulationFileStoreVerifier(QObject *parent)
+		: QObject(parent), m_pool(new QThreadPool(this)), m_generation(0)
 	{
-		if (data)
-			tableData(*data->emulation_variables());
+		m_pool->setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount(), int(MaxThreadCount))));
+
+		reset(EmulationFileStore());
 	}
 
-	// EditFilesTableWidget
-	EditFilesTableWidget::EditFilesTableWidget(QWidget *parent)
-		: EditFilesVariablesTableWidgetBase(parent)
+	EmulationFileStoreVerifier::~EmulationFileStoreVerifier()
 	{
-		init();
+		//     ,       
+		cancel();
+		m_pool->waitForDone();
 	}
 
-	EditFilesTableWidget::EditFilesTableWidget(const std::shared_ptr<emulation_dal::Emulation> emulationData, QWidget *parent)
-		: EditFilesVariablesTableWidgetBase(parent)
+	void EmulationFileStoreVerifier::reset(const EmulationFileStore &store)
 	{
-		init();
+		cancel();
 
-		if (emulationData)
-			setDataVector(*emulationData->emulation_files());
+		m_store = store;
+		m_statuses.clear();
+		m_counts.clear();
+		++m_generation;
+
+		m_cancelFlag = std::make_shared<QAtomicInt>(0);
+		m_throttle = std::make_shared<Throttle>(MaxBytesPerSecond);
 	}
 
-	void EditFilesTableWidget::init()
+	void EmulationFileStoreVerifier::verify(const QStringList &hashes)
 	{
-		setModel(new EditFilesTableModel(this));
-
-		setItemDelegateForColumn(1, new VariableTypesListDelegate(this));
-		setItemDelegateForColumn(2, new VariableLenghtDelegate(this));
+		if (!m_store.isValid())
+			return;
 
-		setSelectionBehavior(SelectRows);
+		for (auto &hash : hashes) {
+			if (hash.isEmpty() || m_statuses.contains(hash))
+				continue;
 
-		if (isSettingsExist())
-			loadSettings();
+			m_statuses.insert(hash, Pending);
+			++m_counts[Pending];
 
-		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+			auto store = m_store;
+			auto throttle = m_throttle;
+			auto cancelFlag = m_cancelFlag;
+			auto generation = m_generation;
 
-		enableGlobalActions();
+			QtConcurrent::run(m_pool, [this, store, hash, throttle, cancelFlag, generation]() {
+				auto result = check(store, hash, *throttle, cancelFlag);
 
+				if (!cancelFlag->load())
+					QMetaObject::invokeMethod(this, "applyResult", Qt::QueuedConnection,
+						Q_ARG(int, generation), Q_ARG(QString, hash), Q_ARG(int, result));
+			});
+		}
 	}
 
-	void EditFilesTableWidget::setDataVector(const emulation_dal::Emulation_file_store &value)
+	EmulationFileStoreVerifier::Status EmulationFileStoreVerifier::status(const QString &hash) const
 	{
-		auto filesModel = model();
+		return m_statuses.value(hash, Unknown);
+	}
 
-		if (filesModel)
-			filesModel->setDataVector(value);
+	int EmulationFileStoreVerifier::count(const Status value) const
+	{
+		return m_counts.value(value);
 	}
 
-	const emulation_dal::Emulation_file_store &EditFilesTableWidget::dataVector() const
+	bool EmulationFileStoreVerifier::isRunning() const
 	{
-		return *model();
+		return m_counts.value(Pending) > 0;
 	}
 
-	void EditFilesTableWidget::clearDataVector()
+	void EmulationFileStoreVerifier::applyResult(int generation, const QString &hash, int status)
 	{
-		auto filesModel = model();
+		if (generation != m_generation || m_statuses.value(hash) != Pending)
+			return;
 
-		if (filesModel)
-			model()->clearDataVector();
+		m_statuses.insert(hash, static_cast<Status>(status));
+		--m_counts[Pending];
+		++m_counts[status];
+
+		emit objectVerified(hash, status);
+
+		if (!m_counts.value(Pending))
+			emit finished();
 	}
 
-	void EditFilesTableWidget::newFileDialog()
+	EmulationFileStoreVerifier::Status EmulationFileStoreVerifier::check(const EmulationFileStore &store, const QString &hash, Throttle &throttle,
+		const std::shared_ptr<QAtomicInt> &cancelFlag)
 	{
-		EditFilesDialog *dialog = new EditFilesDialog(this);
+		QFile file(store.path(hash));
 
-		if (dialog->exec() == QDialog::Accepted) {
-			auto data = dialog->dbData();
+		if (!file.open(QIODevice::ReadOnly))
+			return Missing;
 
-			if (data) {
-				auto filesModel = model();
+		QCryptographicHash sum(QCryptographicHash::Sha256);
+		QByteArray buffer(static_cast<int>(EmulationFileTransfer::ChunkSize), Qt::Uninitialized);
 
-				if (filesModel) {
-					for (auto i : *filesModel) {
-						if (i && i->ef_name().trimmed() == data->ef_name().trimmed()) {
-							Global::Messages::ErrorMessage(tr("File name ") + data->ef_name().trimmed() + tr(" is already exist!"));
-							return;
-						}
-					}
+		for (;;) {
+			if (cancelFlag->load())
+				return Unknown;
 
-					filesModel->push_back(data);
-					emit addFileSignal(data->ef_name());
+			auto length = file.read(buffer.data(), buffer.size());
 
-				}
+			if (length < 0)
+				return Missing;
 
-			}
+			if (length == 0)
+				break;
 
+			sum.addData(buffer.constData(), static_cast<int>(length));
+			throttle.acquire(length);
 		}
 
+		return QString::fromLatin1(sum.result().toHex()) == hash ? Intact : Damaged;
 	}
 
-	void EditFilesTableWidget::editFileDialog(const QString &value)
+	void EmulationFileStoreVerifier::cancel()
 	{
-		auto it = model()->find_by_attribute(emulation_dal::Emulation_file::Attributes::EF_NAME, value);
+		if (m_cancelFlag)
+			m_cancelFlag->store(1);
 
-		if (it != model()->end()) {
+		m_pool->clear();
+	}
 
-			auto lastData = *it;
+	// EmulationTypesCache
+	EmulationTypesCache::EmulationTypesCache(QObject *parent)
+		: QObject(parent), m_variableTypesLoaded(false), m_fileTypesLoaded(false)
+	{
+		init();
+	}
 
-			if (lastData) {
-				QString lastName = lastData->ef_name();
+	EmulationTypesCache *EmulationTypesCache::instance()
+	{
+		static EmulationTypesCache *cache = new EmulationTypesCache(qApp);
 
-				EditFilesDialog *dialog = new EditFilesDialog(lastData, this);
+		return cache;
+	}
 
-				if (dialog->exec() == QDialog::Accepted) {
-					auto newData = dialog->dbData();
+	void EmulationTypesCache::init()
+	{
+		connect(emulation_dal::DB::notifier()->Emulation_variable_type_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(invalidateVariableTypes()));
+		connect(emulation_dal::DB::notifier()->Emulation_variable_type_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(invalidateVariableTypes()));
+		connect(emulation_dal::DB::notifier()->Emulation_variable_type_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(invalidateVariableTypes()));
 
-					if (newData) {
-						auto filesModel = model();
+		connect(emulation_dal::DB::notifier()->Emulation_file_type_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(invalidateFileTypes()));
+		connect(emulation_dal::DB::notifier()->Emulation_file_type_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(invalidateFileTypes()));
+		connect(emulation_dal::DB::notifier()->Emulation_file_type_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(invalidateFileTypes()));
 
-						auto newName = newData->ef_name();
+		loadVariableTypes();
+		loadFileTypes();
+	}
 
-						if (filesModel) {
-							for (auto i : *filesModel) {
-								if (i && i != newData && i->ef_name().trimmed() == newData->ef_name().trimmed()) {
-									newData->ef_name(lastName);
-									Global::Messages::ErrorMessage(tr("File name ") + newName.trimmed() + tr(" is already exist!"));
-									return;
-								}
-							}
+	std::shared_ptr<emulation_dal::Emulation_variable_type> EmulationTypesCache::variableType(const long id)
+	{
+		loadVariableTypes();
 
-							filesModel->at(it, newData);
-							emit editFileSignal(lastName, newName);
+		return m_variableTypes.value(id);
+	}
 
-						}
+	QString EmulationTypesCache::variableTypeName(const long id)
+	{
+		auto type = variableType(id);
 
-					}
+		return type ? type->evt_name() : QString();
+	}
 
-				}
+	std::shared_ptr<emulation_dal::Emulation_file_type> EmulationTypesCache::fileType(const long id)
+	{
+		loadFileTypes();
 
-			}
+		return m_fileTypes.value(id);
+	}
 
-		}
+	QString EmulationTypesCache::fileTypeName(const long id)
+	{
+		auto type = fileType(id);
 
+		return type ? type->eft_name() : QString();
 	}
 
-	void EditFilesTableWidget::removeFile(const QString &value)
+	void EmulationTypesCache::loadVariableTypes()
 	{
-		auto it = model()->find_by_attribute(emulation_dal::Emulation_file::Attributes::EF_NAME, value);
+		if (m_variableTypesLoaded)
+			return;
 
-		if (it != model()->end() && *it) {
-			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
-				auto deletedName = (*it)->ef_name();
-				model()->removeRow(it);
-				emit deleteFileSignal(deletedName);
+		m_variableTypes.clear();
 
-			}
+		auto types = emulation_dal::Emulation_variable_type_store::query(odb::query<emulation_dal::Emulation_variable_type>());
 
+		if (types) {
+			for (auto type : *types) {
+				if (type)
+					m_variableTypes.insert(type->id(), type);
+			}
 		}
 
+		m_variableTypesLoaded = true;
 	}
 
-	void EditFilesTableWidget::onNewAction()
+	void EmulationTypesCache::loadFileTypes()
 	{
-		newFileDialog();
-	}
+		if (m_fileTypesLoaded)
+			return;
 
-	void EditFilesTableWidget::onOpenAction()
-	{
-		QModelIndex idx = currentIndex();
+		m_fileTypes.clear();
 
-		if (idx.isValid()) {
+		auto types = emulation_dal::Emulation_file_type_store::query(odb::query<emulation_dal::Emulation_file_type>());
 
-			auto lastData = model()->at(idx.row());
+		if (types) {
+			for (auto type : *types) {
+				if (type)
+					m_fileTypes.insert(type->id(), type);
+			}
+		}
 
-			if (lastData) {
+		m_fileTypesLoaded = true;
+	}
 
-				QString lastName = lastData->ef_name();
+	void EmulationTypesCache::invalidateVariableTypes()
+	{
+		m_variableTypesLoaded = false;
 
-				EditFilesDialog *dialog = new EditFilesDialog(lastData, this);
+		emit variableTypesChanged();
+	}
 
-				if (dialog->exec() == QDialog::Accepted) {
+	void EmulationTypesCache::invalidateFileTypes()
+	{
+		m_fileTypesLoaded = false;
 
-					auto newData = dialog->dbData();
+		emit fileTypesChanged();
+	}
 
-					if (newData) {
+	// ViewVariablesTableModel
+	ViewVariablesTableModel::ViewVariablesTableModel(QObject *parent)
+		: TableModelBase(parent)
+	{
+		init();
+	}
 
-						auto filesModel = model();
+	ViewVariablesTableModel::ViewVariablesTableModel(const emulation_dal::Emulation_variable_store &value, QObject *parent)
+		: TableModelBase(parent)
+	{
+		static_cast<EmulationVariableRowStore &>(*this) = rows(value);
 
-						auto newName = newData->ef_name();
+		init();
+	}
 
-						if (filesModel) {
-							for (auto i : *filesModel) {
-								if (i && i != newData && i->ef_name().trimmed() == newData->ef_name().trimmed()) {
-									newData->ef_name(lastName);
-									Global::Messages::ErrorMessage(tr("File name ") + newName.trimmed() + tr(" is already exist!"));
-									return;
-								}
-							}
+	void ViewVariablesTableModel::init()
+	{
+		m_rowIndex = new DBModelRowIndex<ViewVariablesTableModel>(this);
 
-							filesModel->at(idx.row(), newData);
-							emit editFileSignal(lastName, newName);
+		m_coalescer = new NotifyEventCoalescer(this);
 
-						}
+		connect(m_coalescer, SIGNAL(batchReady(const NotifyEventBatch &)), SLOT(applyBatch(const NotifyEventBatch &)));
+		connect(EmulationTypesCache::instance(), SIGNAL(variableTypesChanged()), SLOT(updateTypes()));
+	}
 
-					}
+	EmulationVariableRowStore ViewVariablesTableModel::rows(const emulation_dal::Emulation_variable_store &value)
+	{
+		EmulationVariableRowStore result;
+		result.reserve(value.size());
 
-				}
+		for (auto i : value) {
+			if (!i)
+				continue;
 
-			}
+			auto row = std::make_shared<EmulationVariableRow>();
 
+			row->recordId = i->id();
+			row->emulationId = i->emulation_id();
+			row->name = i->ev_name();
+			row->typeId = i->evt_id();
+			row->length = i->ev_length();
+			row->description = i->ev_description();
+			row->dataReady = i->ev_data_ready();
+			row->dataSize = i->ev_data().size();
+			row->dataPrefix = i->ev_data().left(PayloadPreview::DefaultLength);
+
+			result.push_back(row);
 		}
 
+		return result;
 	}
 
-	void EditFilesTableWidget::onDeleteAction()
+	void ViewVariablesTableModel::setDataVector(const emulation_dal::Emulation_variable_store &value)
 	{
-		QModelIndex idx = currentIndex();
-
-		if (idx.isValid()) {
+		setDataVector(rows(value));
+	}
 
-			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
-				auto filesModel = model();
+	void ViewVariablesTableModel::setDataVector(EmulationVariableRowStore value)
+	{
+		beginResetModel();
+		static_cast<EmulationVariableRowStore &>(*this) = std::move(value);
+		endResetModel();
+	}
 
-				if (filesModel) {
-					auto deletedRec = filesModel->at(idx.row());
+	void ViewVariablesTableModel::clearDataVector()
+	{
+		beginResetModel();
+		static_cast<EmulationVariableRowStore &>(*this).clear();
+		endResetModel();
+	}
 
-					filesModel->removeRow(idx.row());
+	std::shared_ptr<emulation_dal::Emulation_variable> ViewVariablesTableModel::record(const int row) const
+	{
+		if (row < 0 || row >= rowCount() || !at(row))
+			return nullptr;
 
-					emit deleteFileSignal(deletedRec->ef_name());
+		return QueryByIdCache<emulation_dal::Emulation_variable_store>::fetch(at(row)->id());
+	}
 
-				}
+	void ViewVariablesTableModel::updateTypes()
+	{
+		if (size() > 0)
+			emit dataChanged(index(0, 1), index(rowCount() - 1, 1));
+	}
 
-			}
+	NotifyEventCoalescer *ViewVariablesTableModel::coalescer() const
+	{
+		return m_coalescer;
+	}
 
-		}
+	void ViewVariablesTableModel::applyBatch(const NotifyEventBatch &batch)
+	{
+		NotifyBatchApplier<EmulationVariableRowStore>::apply(this, batch);
+	}
 
+	void ViewVariablesTableModel::appendRecords(EmulationVariableRowStore records)
+	{
+		NotifyBatchApplier<EmulationVariableRowStore>::appendRecords(this, std::move(records));
 	}
 
-	void EditFilesTableWidget::contextMenuEvent(QContextMenuEvent *e)
+	int ViewVariablesTableModel::rowById(const long id) const
 	{
-		QTableView::contextMenuEvent(e);
+		return m_rowIndex->row(id);
+	}
 
-		QModelIndex cur = currentIndex();
+	bool ViewVariablesTableModel::containsId(const long id) const
+	{
+		return m_rowIndex->contains(id);
+	}
 
-		QMenu contextMenu(tr("Context Menu"));
+	bool ViewVariablesTableModel::appendById(const long id)
+	{
+		if (containsId(id))
+			return false;
 
-		QAction *createAction = contextMenu.addAction(tr("New"));
-		QAction *editAction = contextMenu.addAction(tr("Edit"));
-		contextMenu.addSeparator();
-		QAction *deleteAction = contextMenu.addAction(tr("Delete"));
+		auto row = NotifyRecordCache<EmulationVariableRowStore>::fetch(id);
 
-		if (!cur.isValid()) {
-			editAction->setDisabled(true);
-			deleteAction->setDisabled(true);
-		}
+		if (!row)
+			return false;
 
-		QAction *selectedAction = contextMenu.exec(e->globalPos());
+		appendRecords(EmulationVariableRowStore(1, row));
 
-		if (selectedAction == createAction)
-			onNewAction();
-		else if (selectedAction == editAction)
-			onOpenAction();
-		else if (selectedAction == deleteAction)
-			onDeleteAction();
+		return true;
 	}
 
-	// EditFilesWidget
-	EditFilesWidget::EditFilesWidget(QWidget* parent)
-		: EditFilesVariablesWidgetBase(parent)
+	bool ViewVariablesTableModel::updateById(const long id)
 	{
-		init();
+		if (!containsId(id))
+			return false;
+
+		NotifyEventBatch batch;
+		batch.updated << id;
 
+		applyBatch(batch);
+
+		return true;
 	}
 
-	EditFilesWidget::EditFilesWidget(const std::shared_ptr<emulation_dal::Emulation> data, QWidget* parent)
-		: EditFilesVariablesWidgetBase(parent)
+	bool ViewVariablesTableModel::removeById(const long id)
 	{
-		init();
+		if (!containsId(id))
+			return false;
 
-		loadDBData(data);
+		NotifyEventBatch batch;
+		batch.removed << id;
+
+		applyBatch(batch);
 
+		return true;
 	}
 
-	void EditFilesWidget::init()
+	QVariant ViewVariablesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
 	{
-		QHBoxLayout *fileStoreLayout = new QHBoxLayout();
-
-		m_useFileStoreCheckBox = new CheckBox(tr("Use file store"));
-		m_layout->addWidget(m_useFileStoreCheckBox);
-
-		m_fileStorePath = new QLineEdit();
+		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+			switch (section) {
+			case 0:
+				return QObject::tr("Variable name");
+			case 1:
+				return QObject::tr("Variable type");
+			case 2:
+				return QObject::tr("Lenght");
+			case 3:
+				return QObject::tr("Default value");
+			case 4:
+				return QObject::tr("Description");
+			case 5:
+				return QObject::tr("Value");
+			}
+		}
 
-		fileStoreLayout->addWidget(m_useFileStoreCheckBox);
-		fileStoreLayout->addWidget(m_fileStorePath);
+		return QVariant();
+	}
 
-		m_layout->addLayout(fileStoreLayout);
+	QVariant ViewVariablesTableModel::data(const QModelIndex &index, int role) const
+	{
+		if (!index.isValid() || index.row() < 0 || index.row() >= rowCount() || !at(index.row()))
+			return QVariant();
 
-		EditFilesVariablesWidgetBase::setTableWidget(new EditFilesTableWidget(this));
+		auto row = at(index.row());
 
-		m_label->setText(tr("Scenery files: "));
+		if ((index.column() == 3 || index.column() == 5) && role == Qt::ToolTipRole)
+			return PayloadPreview::toolTip(row->dataSize, row->dataHash);
 
-		connect(m_toolbar->newAction(), SIGNAL(triggered(bool)), SLOT(onNewAction()));
-		connect(m_toolbar->editAction(), SIGNAL(triggered(bool)), SLOT(onOpenAction()));
-		connect(m_toolbar->removeAction(), SIGNAL(triggered(bool)), SLOT(onDeleteAction()));
+		if (role == Qt::DisplayRole || role == Qt::EditRole) {
+			switch (index.column()) {
+			case 0:
+				return row->name;
 
-		connect(table(), SIGNAL(addFileSignal(const QString &)), SIGNAL(addFileSignal(const QString &)));
-		connect(table(), SIGNAL(editFileSignal(const QString &, const QString &)), SIGNAL(editFileSignal(const QString &, const QString &)));
-		connect(table(), SIGNAL(deleteFileSignal(const QString &)), SIGNAL(deleteFileSignal(const QString &)));
+			case 1:
+				return EmulationTypesCache::instance()->variableTypeName(row->typeId);
 
-		connect(m_useFileStoreCheckBox, SIGNAL(stateChanged(int)), SLOT(updateFileStoreAccesibility()));
+			case 2:
+				if (row->length.null() || row->length.get() == -1)
+					return QObject::tr("Arbitrary lenght");
+				else
+					return row->length.get();
 
-		updateFileStoreAccesibility();
+			case 3:
+				if (!row->dataReady)
+					return "-";
+				else
+					return PayloadPreview::prefixText(row->dataPrefix, row->dataSize);
+			case 4:
+				return row->description;
+			case 5:
+				return PayloadPreview::prefixText(row->dataPrefix, row->dataSize);
+			}
+		}
 
+		return QVariant();
 	}
 
-	EditFilesTableWidget *EditFilesWidget::table() const
+	int ViewVariablesTableModel::rowCount(const QModelIndex &parent) const
 	{
-		return dynamic_cast<EditFilesTableWidget *>(EditFilesVariablesWidgetBase::tableWidget());
+		return static_cast<int>(size());
 	}
 
-	bool EditFilesWidget::useFileStore() const
+	int ViewVariablesTableModel::columnCount(const QModelIndex &parent) const
 	{
-		return m_useFileStoreCheckBox->isChecked();
+		return 6;
 	}
 
-	void EditFilesWidget::useFileStore(const bool value)
+	// ViewFilesTableModel
+	ViewFilesTableModel::ViewFilesTableModel(QObject *parent)
+		: TableModelBase(parent)
 	{
-		m_useFileStoreCheckBox->setChecked(value);
+		init();
 	}
 
-	QString EditFilesWidget::fileStorePath() const
+	ViewFilesTableModel::ViewFilesTableModel(const emulation_dal::Emulation_file_store &value, QObject *parent)
+		: TableModelBase(parent)
 	{
-		return m_fileStorePath->text();
-	}
+		static_cast<EmulationFileRowStore &>(*this) = rows(value);
 
-	void EditFilesWidget::fileStorePath(const QString &value)
-	{
-		m_fileStorePath->setText(value);
+		init();
 	}
 
-	void EditFilesWidget::tableData(const emulation_dal::Emulation_file_store &value)
+	void ViewFilesTableModel::init()
 	{
-		table()->setDataVector(value);
-	}
+		m_rowIndex = new DBModelRowIndex<ViewFilesTableModel>(this);
 
-	const emulation_dal::Emulation_file_store &EditFilesWidget::tableData() const
-	{
-		return table()->dataVector();
-	}
+		m_coalescer = new NotifyEventCoalescer(this);
 
-	EditFilesTableModel *EditFilesWidget::tableModel() const
-	{
-		return table()->model();
+		connect(m_coalescer, SIGNAL(batchReady(const NotifyEventBatch &)), SLOT(applyBatch(const NotifyEventBatch &)));
+		connect(EmulationTypesCache::instance(), SIGNAL(fileTypesChanged()), SLOT(updateTypes()));
 	}
 
-	void EditFilesWidget::newVariableDialog()
+	EmulationFileRowStore ViewFilesTableModel::rows(const emulation_dal::Emulation_file_store &value)
 	{
-		table()->newFileDialog();
+		EmulationFileRowStore result;
+		result.reserve(value.size());
+
+		for (auto i : value) {
+			if (!i)
+				continue;
+
+			auto row = std::make_shared<EmulationFileRow>();
+
+			row->recordId = i->id();
+			row->emulationId = i->emulation_id();
+			row->name = i->ef_name();
+			row->typeId = i->eft_id();
+			row->useFileStore = i->ef_use_file_store();
+			row->description = i->ef_description();
+			row->dataReady = i->ef_data_ready();
+			row->dataSize = i->ef_data().size();
+			row->dataPrefix = i->ef_data().left(EmulationFileRow::PrefixLength);
+
+			result.push_back(row);
+		}
+
+		return result;
 	}
 
-	void EditFilesWidget::editVariableDialog(const QString &value)
+	void ViewFilesTableModel::setDataVector(const emulation_dal::Emulation_file_store &value)
 	{
-		table()->editFileDialog(value);
+		setDataVector(rows(value));
 	}
 
-	void EditFilesWidget::removeVariable(const QString &value)
+	void ViewFilesTableModel::setDataVector(EmulationFileRowStore value)
 	{
-		table()->removeFile(value);
+		beginResetModel();
+		static_cast<EmulationFileRowStore &>(*this) = std::move(value);
+		m_storedObjects.clear();
+		endResetModel();
 	}
 
-	void EditFilesWidget::clear()
+	void ViewFilesTableModel::clearDataVector()
 	{
-		table()->clearDataVector();
+		beginResetModel();
+		static_cast<EmulationFileRowStore &>(*this).clear();
+		m_storedObjects.clear();
+		endResetModel();
 	}
 
-	void EditFilesWidget::onNewAction()
+	std::shared_ptr<emulation_dal::Emulation_file> ViewFilesTableModel::record(const int row) const
 	{
-		table()->onNewAction();
+		if (row < 0 || row >= rowCount() || !at(row))
+			return nullptr;
+
+		return QueryByIdCache<emulation_dal::Emulation_file_store>::fetch(at(row)->id());
 	}
 
-	void EditFilesWidget::onOpenAction()
+	const EmulationFileStore &ViewFilesTableModel::fileStore() const
 	{
-		table()->onOpenAction();
+		return m_fileStore;
 	}
 
-	void EditFilesWidget::onDeleteAction()
+	void ViewFilesTableModel::fileStore(const EmulationFileStore &value)
 	{
-		table()->onDeleteAction();
+		m_fileStore = value;
+		m_storedObjects.clear();
+		m_objectStatuses.clear();
+
+		if (size() > 0)
+			emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 	}
 
-	void EditFilesWidget::updateFileStoreAccesibility()
+	QStringList ViewFilesTableModel::storedHashes() const
 	{
-		m_fileStorePath->setEnabled(useFileStore());
+		return storedHashes(0, rowCount() - 1);
 	}
 
-	void EditFilesWidget::loadDBData(const std::shared_ptr<emulation_dal::Emulation> data)
+	QStringList ViewFilesTableModel::storedHashes(const int first, const int last) const
 	{
-		if (data) {
-			tableData(*data->emulation_files());
-			useFileStore(data->emulation_use_file_store());
-			fileStorePath(data->emulation_file_store_path());
-			
-			updateFileStoreAccesibility();
+		QStringList result;
+
+		for (int i = std::max(first, 0); i <= last && i < rowCount(); ++i) {
+			auto row = at(i);
+
+			if (row && row->useFileStore && row->dataSize == EmulationFileStore::ReferenceLength && EmulationFileStore::isReference(row->dataPrefix))
+				result << EmulationFileStore::hash(row->dataPrefix);
 		}
 
+		return result;
 	}
 
-	// DVFSplitterBase
-	DVFSplitterBase::DVFSplitterBase(WidgetBase* parent)
-		: QSplitter(parent), ParentWidget(parent)
+	void ViewFilesTableModel::objectVerified(const QString &hash, int status)
 	{
-		init();
+		if (status == EmulationFileStoreVerifier::Missing || status == EmulationFileStoreVerifier::Damaged)
+			m_objectStatuses.insert(hash, status);
+		else if (!m_objectStatuses.remove(hash))
+			return;
+
+		for (int row = 0; row < rowCount(); ++row) {
+			if (at(row) && at(row)->useFileStore && at(row)->dataSize == EmulationFileStore::ReferenceLength && EmulationFileStore::hash(at(row)->dataPrefix) == hash)
+				emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+		}
 	}
 
-	void DVFSplitterBase::init()
+	std::shared_ptr<const EmulationFileMapping> ViewFilesTableModel::storedObject(const QString &hash) const
 	{
-		QLabel *descriptionLabel = new QLabel(tr("Description:"));
-		m_descriptionEdit = new PlainTextEdit();
-
-		QWidget *descriptionWidget = new QWidget();
-		QVBoxLayout *descriptionLayout = new QVBoxLayout();
-		descriptionLayout->setContentsMargins(0, 0, 0, 0);
-		descriptionWidget->setLayout(descriptionLayout);
+		auto it = m_storedObjects.find(hash);
 
-		descriptionLayout->addWidget(descriptionLabel);
-		descriptionLayout->addWidget(m_descriptionEdit);
+		if (it == m_storedObjects.end())
+			it = m_storedObjects.insert(hash, m_fileStore.map(hash));
 
-		setOrientation(Qt::Vertical);
-		setContentsMargins(0, 0, 0, 0);
+		return it.value();
+	}
 
-		addWidget(descriptionWidget);
+	void ViewFilesTableModel::updateTypes()
+	{
+		if (size() > 0)
+			emit dataChanged(index(0, 1), index(rowCount() - 1, 1));
+	}
 
-		connect(emulation_dal::DB::notifier()->Emulation_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(update(const NotifyEvent &)));
+	NotifyEventCoalescer *ViewFilesTableModel::coalescer() const
+	{
+		return m_coalescer;
+	}
 
+	void ViewFilesTableModel::applyBatch(const NotifyEventBatch &batch)
+	{
+		NotifyBatchApplier<EmulationFileRowStore>::apply(this, batch);
 	}
 
-	void DVFSplitterBase::description(const QString& value)
+	void ViewFilesTableModel::appendRecords(EmulationFileRowStore records)
 	{
-		m_descriptionEdit->setPlainText(value);
+		NotifyBatchApplier<EmulationFileRowStore>::appendRecords(this, std::move(records));
 	}
 
-	QString DVFSplitterBase::description() const
+	int ViewFilesTableModel::rowById(const long id) const
 	{
-		return m_descriptionEdit->toPlainText();
+		return m_rowIndex->row(id);
 	}
 
-	void DVFSplitterBase::clear()
+	bool ViewFilesTableModel::containsId(const long id) const
 	{
-		m_descriptionEdit->clear();
+		return m_rowIndex->contains(id);
 	}
 
-	void DVFSplitterBase::loadDBData()
+	bool ViewFilesTableModel::appendById(const long id)
 	{
-		clear();
+		if (containsId(id))
+			return false;
 
-		auto data = dbData();
+		auto row = NotifyRecordCache<EmulationFileRowStore>::fetch(id);
 
-		if (data) {
-			description(data->emulation_description());
-		}
+		if (!row)
+			return false;
+
+		appendRecords(EmulationFileRowStore(1, row));
 
+		return true;
 	}
 
-	void DVFSplitterBase::updateDBData()
+	bool ViewFilesTableModel::updateById(const long id)
 	{
-		auto data = dbData();
+		if (!containsId(id))
+			return false;
 
-		if (data)
-			data->emulation_description(description());
+		NotifyEventBatch batch;
+		batch.updated << id;
+
+		applyBatch(batch);
+
+		return true;
 	}
 
-	void DVFSplitterBase::update(const NotifyEvent &ev)
+	bool ViewFilesTableModel::removeById(const long id)
 	{
-		auto emulation = emulation_dal::Emulation_store::query_one_by_id(ev.objectId());
+		if (!containsId(id))
+			return false;
 
-		auto data = dbData();
+		NotifyEventBatch batch;
+		batch.removed << id;
 
-		if (emulation && data && *data == *emulation)
-			description(emulation->emulation_description());
+		applyBatch(batch);
 
+		return true;
 	}
 
-	// ViewDVFSplitter
-	ViewDVFSplitter::ViewDVFSplitter(WidgetBase* parent)
-		: DVFSplitterBase(parent)
+	QVariant ViewFilesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
 	{
-		init();
+		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+			switch (section) {
+			case 0:
+				return QObject::tr("File name");
+			case 1:
+				return QObject::tr("File type");
+			case 2:
+				return QObject::tr("Data flag");
+			case 3:
+				return QObject::tr("Data");
+			case 4:
+				return QObject::tr("Use store");
+			case 5:
+				return QObject::tr("Description");
+			}
+		}
+
+		return QVariant();
+
 	}
 
-	void ViewDVFSplitter::init()
+	QVariant ViewFilesTableModel::data(const QModelIndex &index, int role) const
 	{
-		//   
-		m_variablesWidget = new ViewVariablesWidget(this);
-		addWidget(m_variablesWidget);
+		if (!index.isValid() || index.row() < 0 || index.row() >= rowCount() || !at(index.row()))
+			return QVariant();
 
-		//   
-		m_filesWidget = new ViewFilesWidget(this);
-		addWidget(m_filesWidget);
+		auto row = at(index.row());
 
-		m_descriptionEdit->setReadOnly(true);
+		auto storedHash = row->useFileStore && row->dataSize == EmulationFileStore::ReferenceLength ? EmulationFileStore::hash(row->dataPrefix) : QString();
 
-		if (isSettingsExist())
-			loadSettings();
+		auto objectStatus = storedHash.isEmpty() ? 0 : m_objectStatuses.value(storedHash);
 
-		connect(this, SIGNAL(splitterMoved(int, int)), SLOT(saveSettings()));
+		if (objectStatus && role == Qt::BackgroundRole)
+			return QColor(Qt::red).lighter(170);
 
-		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(appendVariable(const NotifyEvent &)));
-		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateVariable(const NotifyEvent &)));
-		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(removeVariable(const NotifyEvent &)));
+		if (index.column() == 3 && role == Qt::ToolTipRole) {
+			if (objectStatus == EmulationFileStoreVerifier::Missing)
+				return QObject::tr("File store object is missing: ") + m_fileStore.path(storedHash);
 
-		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(appendFile(const NotifyEvent &)));
-		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateFile(const NotifyEvent &)));
-		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(removeFile(const NotifyEvent &)));
+			if (objectStatus == EmulationFileStoreVerifier::Damaged)
+				return QObject::tr("File store object is damaged (checksum mismatch): ") + m_fileStore.path(storedHash);
+
+			if (!storedHash.isEmpty())
+				return QObject::tr("File store object: ") + m_fileStore.path(storedHash);
+
+			return PayloadPreview::toolTip(row->dataSize, row->dataHash);
+		}
 
+		if (index.column() == 3 && !storedHash.isEmpty() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+			auto object = storedObject(storedHash);
+
+			if (!object)
+				return QString("[%1] sha256:%2%3").arg(QObject::tr("missing"), storedHash.left(12), QChar(0x2026));
+
+			return PayloadPreview::prefixText(object->bytes(), object->size());
+		}
+
+		if (role == Qt::DisplayRole || role == Qt::EditRole) {
+			switch (index.column()) {
+			case 0:
+				return row->name;
+
+			case 1:
+				return EmulationTypesCache::instance()->fileTypeName(row->typeId);
+
+			case 2:
+				return row->dataReady;
+			case 3:
+				return PayloadPreview::prefixText(EmulationFileCodec::head(row->dataPrefix), EmulationFileCodec::size(row->dataPrefix, row->dataSize));
+			case 4:
+				return row->useFileStore;
+			case 5:
+				return row->description;
+			}
+		}
+
+		return QVariant();
 	}
 
-	void ViewDVFSplitter::clear()
+	int ViewFilesTableModel::rowCount(const QModelIndex &parent) const
 	{
-		DVFSplitterBase::clear();
-
-		m_variablesWidget->clear();
-		m_filesWidget->clear();
+		return static_cast<int>(size());
 	}
 
-	void ViewDVFSplitter::variablesData(const emulation_dal::Emulation_variable_store &value)
+	int ViewFilesTableModel::columnCount(const QModelIndex &parent) const
 	{
-		m_variablesWidget->tableData(value);
+		return 6;
 	}
 
-	void ViewDVFSplitter::filesData(const emulation_dal::Emulation_file_store &value)
+	// EditVariablesTableModel
+	EditVariablesTableModel::EditVariablesTableModel(QObject *parent)
+		: DBTableModel<emulation_dal::Emulation_variable>(DoNotAutoLoad, parent)
 	{
-		m_filesWidget->tableData(value);
+		init();
 	}
 
-	ViewVariablesTableModel *ViewDVFSplitter::model() const
+	EditVariablesTableModel::EditVariablesTableModel(emulation_dal::Emulation_variable_store &value, QObject *parent)
+		: DBTableModel<emulation_dal::Emulation_variable>(value, parent)
 	{
-		return m_variablesWidget->tableModel();
+		init();
 	}
 
-	void ViewDVFSplitter::setEditable(const bool flag)
+	void EditVariablesTableModel::init()
 	{
-		m_descriptionEdit->setEnabled(flag);
+		m_nameIndex = new DBModelNameIndex<EditVariablesTableModel>(this);
+
+		m_changes.reset(*this);
+
+		connect(EmulationTypesCache::instance(), SIGNAL(variableTypesChanged()), SLOT(updateTypes()));
 	}
 
-	void ViewDVFSplitter::loadDBData()
+	void EditVariablesTableModel::updateTypes()
 	{
-		clear();
+		if (size() > 0)
+			emit dataChanged(index(0, 1), index(size() - 1, 1));
+	}
 
-		DVFSplitterBase::loadDBData();
+	QString EditVariablesTableModel::nameAt(const int row) const
+	{
+		auto record = at(row);
 
-		auto data = dbData();
+		return record ? record->ev_name() : QString();
+	}
+
+	int EditVariablesTableModel::rowByName(const QString &name) const
+	{
+		return m_nameIndex->row(name);
+	}
+
+	bool EditVariablesTableModel::containsName(const QString &name) const
+	{
+		return m_nameIndex->contains(name);
+	}
+
+	void EditVariablesTableModel::setDataVector(const emulation_dal::Emulation_variable_store &value)
+	{
+		DBTableModel<emulation_dal::Emulation_variable>::setDataVector(value);
+
+		m_changes.reset(*this);
+	}
+
+	void EditVariablesTableModel::clearDataVector()
+	{
+		DBTableModel<emulation_dal::Emulation_variable>::clearDataVector();
+
+		m_changes.reset(*this);
+	}
+
+	void EditVariablesTableModel::markUpdated(const int row)
+	{
+		auto record = at(row);
+
+		if (record)
+			m_changes.markUpdated(record->id());
+	}
+
+	void EditVariablesTableModel::replace(const int row, const std::shared_ptr<emulation_dal::Emulation_variable> &value)
+	{
+		at(row, value);
+		markUpdated(row);
+
+		emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+	}
+
+	bool EditVariablesTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+	{
+		if (!DBTableModel<emulation_dal::Emulation_variable>::setData(index, value, role))
+			return false;
+
+		markUpdated(index.row());
+
+		return true;
+	}
+
+	void EditVariablesTableModel::markPersisted(const std::shared_ptr<emulation_dal::Emulation_variable> &record)
+	{
+		m_changes.markPersisted(record);
+	}
+
+	emulation_dal::Emulation_variable_store EditVariablesTableModel::insertedRecords() const
+	{
+		return m_changes.inserted(*this);
+	}
+
+	emulation_dal::Emulation_variable_store EditVariablesTableModel::updatedRecords() const
+	{
+		return m_changes.updated(*this);
+	}
+
+	QSet<long> EditVariablesTableModel::removedIds() const
+	{
+		return m_changes.removed(*this);
+	}
+
+	bool EditVariablesTableModel::hasChanges() const
+	{
+		return m_changes.hasChanges(*this);
+	}
+
+	void EditVariablesTableModel::acceptChanges()
+	{
+		m_changes.reset(*this);
+	}
+
+	QVariant EditVariablesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	{
+		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+			switch (section) {
+			case 0:
+				return QObject::tr("Variable name");
+			case 1:
+				return QObject::tr("Variable type");
+			case 2:
+				return QObject::tr("Lenght");
+			case 3:
+				return QObject::tr("Default value");
+			case 4:
+				return QObject::tr("Description");
+			case 5:
+				return QObject::tr("Value");
+			}
+		}
+
+		return QVariant();
+	}
+
+	QVariant EditVariablesTableModel::data(const QModelIndex &index, int role) const
+	{
+		std::shared_ptr<emulation_dal::Emulation> curEmulation;
+		odb::nullable<__int64> curLenght;
+
+		if (index.isValid() && (index.column() == 3 || index.column() == 5) && role == Qt::ToolTipRole) {
+			if (index.row() >= 0 && index.row() < size() && at(index.row()))
+				return PayloadPreview::toolTip(at(index.row())->ev_data().size(), QString());
+		}
+
+		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+			if (index.row() >= 0 && index.row() < size()) {
+				switch (index.column()) {
+				case 0:
+					return at(index.row())->ev_name();
+
+				case 1:
+					return EmulationTypesCache::instance()->variableTypeName(at(index.row())->evt_id());
+
+				case 2:
+					curLenght = at(index.row())->ev_length();
+
+					if (curLenght.null() || curLenght.get() == -1)
+						return QObject::tr("Arbitrary lenght");
+					else
+						return curLenght.get();
+
+					break;
+
+				case 3:
+					if (!at(index.row())->ev_data_ready())
+						return "-";
+					else if (role == Qt::DisplayRole)
+						return PayloadPreview::text(at(index.row())->ev_data());
+					else
+						return at(index.row())->ev_data();
+				case 4:
+					return at(index.row())->ev_description();
+				case 5:
+					if (role == Qt::DisplayRole)
+						return PayloadPreview::text(at(index.row())->ev_data());
+					else
+						return at(index.row())->ev_data();
+				}
+			}
+		}
+
+		return QVariant();
+	}
+
+	int EditVariablesTableModel::rowCount(const QModelIndex &parent) const
+	{
+		return size();
+	}
+
+	int EditVariablesTableModel::columnCount(const QModelIndex &parent) const
+	{
+		return 6;
+	}
+
+	// EditVariablesTableModel
+	EditFilesTableModel::EditFilesTableModel(QObject *parent)
+		: DBTableModel<emulation_dal::Emulation_file>(DoNotAutoLoad, parent)
+	{
+		init();
+	}
+
+	EditFilesTableModel::EditFilesTableModel(emulation_dal::Emulation_file_store &value, QObject *parent)
+		: DBTableModel<emulation_dal::Emulation_file>(value, parent)
+	{
+		init();
+	}
+
+	void EditFilesTableModel::init()
+	{
+		m_nameIndex = new DBModelNameIndex<EditFilesTableModel>(this);
+
+		m_changes.reset(*this);
+
+		connect(EmulationTypesCache::instance(), SIGNAL(fileTypesChanged()), SLOT(updateTypes()));
+	}
+
+	void EditFilesTableModel::updateTypes()
+	{
+		if (size() > 0)
+			emit dataChanged(index(0, 1), index(size() - 1, 1));
+	}
+
+	QString EditFilesTableModel::nameAt(const int row) const
+	{
+		auto record = at(row);
+
+		return record ? record->ef_name() : QString();
+	}
+
+	int EditFilesTableModel::rowByName(const QString &name) const
+	{
+		return m_nameIndex->row(name);
+	}
+
+	bool EditFilesTableModel::containsName(const QString &name) const
+	{
+		return m_nameIndex->contains(name);
+	}
+
+	void EditFilesTableModel::setDataVector(const emulation_dal::Emulation_file_store &value)
+	{
+		DBTableModel<emulation_dal::Emulation_file>::setDataVector(value);
+
+		m_changes.reset(*this);
+	}
+
+	void EditFilesTableModel::clearDataVector()
+	{
+		DBTableModel<emulation_dal::Emulation_file>::clearDataVector();
+
+		m_changes.reset(*this);
+	}
+
+	void EditFilesTableModel::markUpdated(const int row)
+	{
+		auto record = at(row);
+
+		if (record)
+			m_changes.markUpdated(record->id());
+	}
+
+	void EditFilesTableModel::replace(const int row, const std::shared_ptr<emulation_dal::Emulation_file> &value)
+	{
+		at(row, value);
+		markUpdated(row);
+
+		emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+	}
+
+	bool EditFilesTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+	{
+		if (!DBTableModel<emulation_dal::Emulation_file>::setData(index, value, role))
+			return false;
+
+		markUpdated(index.row());
+
+		return true;
+	}
+
+	void EditFilesTableModel::markPersisted(const std::shared_ptr<emulation_dal::Emulation_file> &record)
+	{
+		m_changes.markPersisted(record);
+	}
+
+	emulation_dal::Emulation_file_store EditFilesTableModel::insertedRecords() const
+	{
+		return m_changes.inserted(*this);
+	}
+
+	emulation_dal::Emulation_file_store EditFilesTableModel::updatedRecords() const
+	{
+		return m_changes.updated(*this);
+	}
+
+	QSet<long> EditFilesTableModel::removedIds() const
+	{
+		return m_changes.removed(*this);
+	}
+
+	bool EditFilesTableModel::hasChanges() const
+	{
+		return m_changes.hasChanges(*this);
+	}
+
+	void EditFilesTableModel::acceptChanges()
+	{
+		m_changes.reset(*this);
+	}
+
+	QVariant EditFilesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+	{
+		if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+			switch (section) {
+			case 0:
+				return QObject::tr("File name");
+			case 1:
+				return QObject::tr("File type");
+			case 2:
+				return QObject::tr("Data flag");
+			case 3:
+				return QObject::tr("Data");
+			case 4:
+				return QObject::tr("Use store");
+			case 5:
+				return QObject::tr("Description");
+			}
+		}
+
+		return QVariant();
+	}
+
+	QVariant EditFilesTableModel::data(const QModelIndex &index, int role) const
+	{
+		std::shared_ptr<emulation_dal::Emulation> curEmulation;
+		odb::nullable<__int64> curLenght;
+
+		if (index.isValid() && index.column() == 3 && index.row() >= 0 && index.row() < size() && at(index.row())
+			&& at(index.row())->ef_use_file_store() && EmulationFileStore::isReference(at(index.row())->ef_data())) {
+			auto storedHash = EmulationFileStore::hash(at(index.row())->ef_data());
+			auto object = storedObject(storedHash);
+
+			if (role == Qt::ToolTipRole)
+				return (object ? QObject::tr("File store object: ") : QObject::tr("File store object is missing: ")) + m_fileStore.path(storedHash);
+
+			if (role == Qt::DisplayRole)
+				return object ? PayloadPreview::prefixText(object->bytes(), object->size())
+					: QString("[%1] sha256:%2%3").arg(QObject::tr("missing"), storedHash.left(12), QChar(0x2026));
+
+			if (role == Qt::EditRole)
+				return object && object->size() <= EmulationFileTransfer::MaxDatabasePayload
+					? QVariant(QByteArray(object->data(), static_cast<int>(object->size()))) : QVariant();
+		}
+
+		if (index.isValid() && index.column() == 3 && role == Qt::ToolTipRole) {
+			if (index.row() >= 0 && index.row() < size() && at(index.row()))
+				return PayloadPreview::toolTip(EmulationFileCodec::size(at(index.row())->ef_data(), at(index.row())->ef_data().size()), QString());
+		}
+
+		if (index.isValid() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+			if (index.row() >= 0 && index.row() < size()) {
+				switch (index.column()) {
+				case 0:
+					return at(index.row())->ef_name();
+
+				case 1:
+					return EmulationTypesCache::instance()->fileTypeName(at(index.row())->eft_id());
+
+				case 2:
+					return at(index.row())->ef_data_ready();
+				case 3:
+					if (role == Qt::DisplayRole) {
+						const QByteArray &data = at(index.row())->ef_data();
+
+						return PayloadPreview::prefixText(EmulationFileCodec::head(data), EmulationFileCodec::size(data, data.size()));
+					}
+					else
+						return EmulationFileCodec::data(*at(index.row()));
+				case 4:
+					return at(index.row())->ef_use_file_store();
+				case 5:
+					return at(index.row())->ef_description();
+				}
+			}
+		}
+
+		return QVariant();
+	}
+
+	void EditFilesTableModel::fileStore(const EmulationFileStore &value)
+	{
+		m_fileStore = value;
+		m_storedObjects.clear();
+
+		if (size() > 0)
+			emit dataChanged(index(0, 3), index(rowCount() - 1, 3));
+	}
+
+	std::shared_ptr<const EmulationFileMapping> EditFilesTableModel::storedObject(const QString &hash) const
+	{
+		auto it = m_storedObjects.find(hash);
+
+		if (it == m_storedObjects.end())
+			it = m_storedObjects.insert(hash, m_fileStore.map(hash));
+
+		return it.value();
+	}
+
+	int EditFilesTableModel::rowCount(const QModelIndex &parent) const
+	{
+		return size();
+	}
+
+	int EditFilesTableModel::columnCount(const QModelIndex &parent) const
+	{
+		return 6;
+	}
+
+	// ViewVariablesTableWidget
+	ViewVariablesTableWidget::ViewVariablesTableWidget(QWidget *parent)
+		: DBTableViewBase(parent)
+	{
+		setModel(new ViewVariablesTableModel(this));
+
+		init();
+	}
+
+	ViewVariablesTableWidget::ViewVariablesTableWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent)
+		: DBTableViewBase(parent)
+	{
+		setModel(new ViewVariablesTableModel(value, this));
+
+		init();
+	}
+
+	void ViewVariablesTableWidget::init()
+	{
+		setSelectionBehavior(SelectRows);
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+
+		enableGlobalActions();
+
+	}
+
+	void ViewVariablesTableWidget::setDataVector(const emulation_dal::Emulation_variable_store &value)
+	{
+		auto variablesModel = model();
+
+		if (variablesModel)
+			variablesModel->setDataVector(value);
+	}
+
+	void ViewVariablesTableWidget::clearDataVector()
+	{
+		auto variablesModel = model();
+
+		if (variablesModel)
+			variablesModel->clearDataVector();
+	}
+
+	// ViewVariablesWidget
+	ViewVariablesWidget::ViewVariablesWidget(QWidget* parent)
+		: QWidget(parent)
+	{
+		m_table = new ViewVariablesTableWidget(this);
+
+		init();
+	}
+
+	ViewVariablesWidget::ViewVariablesWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent)
+		: QWidget(parent)
+	{
+		m_table = new ViewVariablesTableWidget(value, this);
+
+		init();
+	}
+
+	void ViewVariablesWidget::init()
+	{
+		m_label = new QLabel(tr("Scenery variables: "));
+
+		m_layout = new QVBoxLayout();
+		m_layout->setContentsMargins(0, 0, 0, 0);
+		setLayout(m_layout);
+
+		m_layout->addWidget(m_label);
+		m_layout->addWidget(m_table);
+
+	}
+
+	void ViewVariablesWidget::tableData(const emulation_dal::Emulation_variable_store &value)
+	{
+		m_table->setDataVector(value);
+	}
+
+	ViewVariablesTableModel *ViewVariablesWidget::tableModel() const
+	{
+		return m_table->model();
+	}
+
+	void ViewVariablesWidget::clear()
+	{
+		tableModel()->coalescer()->clear();
+
+		m_table->clearDataVector();
+	}
+
+	bool ViewVariablesWidget::appendById(const long id)
+	{
+		return tableModel()->appendById(id);
+	}
+
+	bool ViewVariablesWidget::updateById(const long id)
+	{
+		return tableModel()->updateById(id);
+	}
+
+	bool ViewVariablesWidget::removeById(const long id)
+	{
+		return tableModel()->removeById(id);
+	}
+
+	// ViewFilesTableWidget
+	ViewFilesTableWidget::ViewFilesTableWidget(QWidget *parent)
+		: DBTableViewBase(parent)
+	{
+		setModel(new ViewFilesTableModel(this));
+
+		init();
+	}
+
+	ViewFilesTableWidget::ViewFilesTableWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent)
+		: DBTableViewBase(parent)
+	{
+		setModel(new ViewFilesTableModel(value, this));
+
+		init();
+	}
+
+	void ViewFilesTableWidget::init()
+	{
+		setSelectionBehavior(SelectRows);
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+
+		enableGlobalActions();
+
+	}
+
+	void ViewFilesTableWidget::setDataVector(const emulation_dal::Emulation_file_store &value)
+	{
+		auto filesModel = model();
+
+		if (filesModel)
+			filesModel->setDataVector(value);
+	}
+
+	void ViewFilesTableWidget::clearDataVector()
+	{
+		auto filesModel = model();
+
+		if (filesModel)
+			filesModel->clearDataVector();
+	}
+
+	void ViewFilesTableWidget::saveContent()
+	{
+		auto filesModel = model();
+		QModelIndex idx = currentIndex();
+
+		if (!filesModel || !idx.isValid() || !filesModel->at(idx.row()))
+			return;
+
+		auto fileId = filesModel->at(idx.row())->id();
+		auto fileName = QFileDialog::getSaveFileName(this, tr("Save file content"), filesModel->at(idx.row())->name);
+
+		if (fileName.isEmpty())
+			return;
+
+		QSaveFile target(fileName);
+
+		if (!target.open(QIODevice::WriteOnly)) {
+			Global::Messages::ErrorMessage(tr("Unable to open file ") + fileName);
+			return;
+		}
+
+		//      ,      
+		EmulationFileStore store = filesModel->fileStore();
+
+		bool saved = EmulationFileTransfer::exec(this, tr("Saving file content..."),
+			[fileId, store, &target](const EmulationFileTransfer::Progress &progress, const std::shared_ptr<QAtomicInt> &cancelFlag) {
+				return EmulationFileTransfer::read(fileId, store, &target, progress, cancelFlag);
+			});
+
+		if (saved)
+			target.commit();
+		else
+			target.cancelWriting();
+	}
+
+	void ViewFilesTableWidget::contextMenuEvent(QContextMenuEvent *e)
+	{
+		QTableView::contextMenuEvent(e);
+
+		QMenu contextMenu(tr("Context Menu"));
+
+		QAction *saveAction = contextMenu.addAction(tr("Save content to file..."));
+
+		if (!currentIndex().isValid())
+			saveAction->setDisabled(true);
+
+		if (contextMenu.exec(e->globalPos()) == saveAction)
+			saveContent();
+	}
+
+	// ViewFilesWidget
+	ViewFilesWidget::ViewFilesWidget(QWidget* parent)
+		: QWidget(parent)
+	{
+		m_table = new ViewFilesTableWidget(this);
+
+		init();
+	}
+
+	ViewFilesWidget::ViewFilesWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent)
+		: QWidget(parent)
+	{
+		m_table = new ViewFilesTableWidget(value, this);
+
+		init();
+	}
+
+	void ViewFilesWidget::init()
+	{
+		m_label = new QLabel(tr("Scenery files: "));
+
+		m_useFileStoreLabel = new QLabel();
+
+		m_integrityLabel = new QLabel();
+		m_integrityLabel->setVisible(false);
+
+		m_usageWatcher = new QFutureWatcher<EmulationFileStore::Usage>(this);
+		connect(m_usageWatcher, SIGNAL(finished()), SLOT(usageReady()));
+
+		m_verifier = new EmulationFileStoreVerifier(this);
+		connect(m_verifier, SIGNAL(objectVerified(const QString &, int)), tableModel(), SLOT(objectVerified(const QString &, int)));
+		connect(m_verifier, SIGNAL(objectVerified(const QString &, int)), SLOT(updateIntegrityLabel()));
+
+		connect(tableModel(), SIGNAL(modelReset()), SLOT(verifyFileStore()));
+		connect(tableModel(), SIGNAL(rowsInserted(const QModelIndex &, int, int)), SLOT(verifyRows(const QModelIndex &, int, int)));
+		connect(tableModel(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), SLOT(verifyRows(const QModelIndex &, const QModelIndex &)));
+
+		m_layout = new QVBoxLayout();
+		m_layout->setContentsMargins(0, 0, 0, 0);
+		setLayout(m_layout);
+
+		m_layout->addWidget(m_label);
+		m_layout->addWidget(m_useFileStoreLabel);
+		m_layout->addWidget(m_integrityLabel);
+		m_layout->addWidget(m_table);
+
+	}
+
+	void ViewFilesWidget::tableData(const emulation_dal::Emulation_file_store &value)
+	{
+		m_table->setDataVector(value);
+	}
+
+	ViewFilesTableModel *ViewFilesWidget::tableModel() const
+	{
+		return m_table->model();
+	}
+
+	void ViewFilesWidget::clear()
+	{
+		tableModel()->coalescer()->clear();
+
+		m_verifier->reset(tableModel()->fileStore());
+		m_table->clearDataVector();
+	}
+
+	void ViewFilesWidget::useFileStore(const bool value, const QString path)
+	{
+		EmulationFileStore store(value ? path : QString());
+
+		m_verifier->reset(store);
+		tableModel()->fileStore(store);
+
+		verifyFileStore();
+
+		if (value) {
+			auto trimmedPath = path.trimmed();
+
+			if (trimmedPath.isEmpty()) {
+				m_useFileStoreLabel->setText(tr("Use file store"));
+
+			}
+			else {
+				m_useFileStoreLabel->setText(tr("Use file store, path: ") + trimmedPath);
+
+				m_usageWatcher->setFuture(QtConcurrent::run([store]() {
+					return store.usage(store.references());
+				}));
+			}
+
+		}
+		else
+			m_useFileStoreLabel->setText(tr("Dont use file store"));
+
+	}
+
+	void ViewFilesWidget::usageReady()
+	{
+		auto usage = m_usageWatcher->result();
+		auto store = tableModel()->fileStore();
+
+		if (!store.isValid() || usage.references == 0)
+			return;
+
+		m_useFileStoreLabel->setText(tr("Use file store, path: ") + store.root() + ". " +
+			tr("Deduplication saved %1 (%2 references to %3 objects)").arg(PayloadPreview::size(usage.savedSize())).arg(usage.references).arg(usage.objects));
+	}
+
+	void ViewFilesWidget::verifyFileStore()
+	{
+		m_verifier->verify(tableModel()->storedHashes());
+
+		updateIntegrityLabel();
+	}
+
+	void ViewFilesWidget::verifyRows(const QModelIndex &parent, int first, int last)
+	{
+		m_verifier->verify(tableModel()->storedHashes(first, last));
+
+		updateIntegrityLabel();
+	}
+
+	void ViewFilesWidget::verifyRows(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+	{
+		verifyRows(QModelIndex(), topLeft.row(), bottomRight.row());
+	}
+
+	void ViewFilesWidget::updateIntegrityLabel()
+	{
+		int missing = m_verifier->count(EmulationFileStoreVerifier::Missing);
+		int damaged = m_verifier->count(EmulationFileStoreVerifier::Damaged);
+		int pending = m_verifier->count(EmulationFileStoreVerifier::Pending);
+		int intact = m_verifier->count(EmulationFileStoreVerifier::Intact);
+
+		m_integrityLabel->setVisible(missing + damaged + pending + intact > 0);
+
+		QString text;
+
+		if (missing || damaged)
+			text = tr("File store check: %1 missing, %2 damaged objects").arg(missing).arg(damaged);
+		else if (!pending)
+			text = tr("File store check: all %1 objects are intact").arg(intact);
+
+		if (pending)
+			text += (text.isEmpty() ? tr("File store check: ") : QString(", ")) + tr("%1 objects are being checked...").arg(pending);
+
+		if (missing || damaged)
+			m_integrityLabel->setText(QString("<font color=\"red\">%1</font>").arg(text.toHtmlEscaped()));
+		else
+			m_integrityLabel->setText(text.toHtmlEscaped());
+	}
+
+	bool ViewFilesWidget::appendById(const long id)
+	{
+		return tableModel()->appendById(id);
+	}
+
+	bool ViewFilesWidget::updateById(const long id)
+	{
+		return tableModel()->updateById(id);
+	}
+
+	bool ViewFilesWidget::removeById(const long id)
+	{
+		return tableModel()->removeById(id);
+	}
+
+	// EditFilesVariablesTableWidgetBase
+	EditFilesVariablesTableWidgetBase::EditFilesVariablesTableWidgetBase(QWidget *parent)
+		: DBTableViewBase(parent)
+	{
+		init();
+	}
+
+	void EditFilesVariablesTableWidgetBase::init()
+	{
+		connect(this, SIGNAL(selectionChanged(const QModelIndex)), SLOT(enableGlobalActions()));
+	}
+
+	void EditFilesVariablesTableWidgetBase::enableGlobalActions()
+	{
+		enableNewAction();
+
+		if (currentIndex().isValid()) {
+			enableOpenAction();
+			enableDeleteAction();
+		}
+	}
+
+	// EditFilesVariablesWidgetBase
+	EditFilesVariablesWidgetBase::EditFilesVariablesWidgetBase(QWidget* parent)
+		: QWidget(parent)
+	{
+		init();
+	}
+
+	void EditFilesVariablesWidgetBase::init()
+	{
+		m_toolbar = new NERToolbar(tr("Edit variables toolbar"));
+
+		m_label = new QLabel();
+
+		m_layout = new QVBoxLayout();
+		m_layout->setContentsMargins(0, 0, 0, 0);
+		setLayout(m_layout);
+
+		QHBoxLayout *labelLayout = new QHBoxLayout();
+
+		labelLayout->addWidget(m_label);
+		labelLayout->addStretch();
+		labelLayout->addWidget(m_toolbar);
+
+		m_layout->addLayout(labelLayout);
+
+		int buttonsHeight = m_label->fontMetrics().height();
+
+		if (buttonsHeight > 0)
+			m_toolbar->setIconSize(QSize(buttonsHeight, buttonsHeight));
+
+	}
+
+	void EditFilesVariablesWidgetBase::updateControlsAccesibility()
+	{
+		if (m_table) {
+			if (m_table->currentIndex().isValid())
+			{
+				m_toolbar->editAction()->setEnabled(true);
+				m_toolbar->removeAction()->setEnabled(true);
+
+			}
+			else {
+				m_toolbar->editAction()->setEnabled(false);
+				m_toolbar->removeAction()->setEnabled(false);
+
+			}
+		}
+		else
+			m_toolbar->disableAllActions();
+
+	}
+
+	EditFilesVariablesTableWidgetBase *EditFilesVariablesWidgetBase::tableWidget() const
+	{
+		return m_table;
+
+	}
+
+	void EditFilesVariablesWidgetBase::setTableWidget(EditFilesVariablesTableWidgetBase *value)
+	{
+		if (!m_table) {
+			m_table = value;
+
+			m_layout->addWidget(m_table);
+
+			connect(m_table, SIGNAL(selectionChanged(const QModelIndex)), SLOT(updateControlsAccesibility()));
+
+			updateControlsAccesibility();
+		}
+		else
+			throw std::exception();
+
+	}
+
+	// EditVariablesTableWidget
+	EditVariablesTableWidget::EditVariablesTableWidget(QWidget *parent)
+		: EditFilesVariablesTableWidgetBase(parent)
+	{
+		init();
+	}
+
+	EditVariablesTableWidget::EditVariablesTableWidget(const std::shared_ptr<emulation_dal::Emulation> emulationData, QWidget *parent)
+		: EditFilesVariablesTableWidgetBase(parent)
+	{
+		init();
+
+		if (emulationData)
+			setDataVector(*emulationData->emulation_variables());
+
+	}
+
+	void EditVariablesTableWidget::init()
+	{
+		setModel(new EditVariablesTableModel(this));
+
+		setItemDelegateForColumn(1, new VariableTypesListDelegate(this));
+		setItemDelegateForColumn(2, new VariableLenghtDelegate(this));
+
+		setSelectionBehavior(SelectRows);
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+
+		enableGlobalActions();
+
+	}
+
+	void EditVariablesTableWidget::setDataVector(const emulation_dal::Emulation_variable_store &value)
+	{
+		auto variablesModel = model();
+
+		if (variablesModel)
+			variablesModel->setDataVector(value);
+	}
+
+	const emulation_dal::Emulation_variable_store &EditVariablesTableWidget::dataVector() const
+	{
+		return *model();
+	}
+
+	void EditVariablesTableWidget::clearDataVector()
+	{
+		auto variablesModel = model();
+
+		if (variablesModel)
+			variablesModel->clearDataVector();
+	}
+
+	void EditVariablesTableWidget::newVariableDialog()
+	{
+		EditVariablesDialog *dialog = new EditVariablesDialog(this);
+
+		if (dialog->exec() == QDialog::Accepted) {
+			auto data = dialog->dbData();
+
+			if (data) {
+
+				auto variablesModel = model();
+
+				if (variablesModel) {
+					if (variablesModel->containsName(data->ev_name())) {
+						Global::Messages::ErrorMessage(tr("Variable name ") + data->ev_name().trimmed() + tr(" is already exist!"));
+						return;
+					}
+
+					variablesModel->push_back(data);
+					emit addVariableSignal(data->ev_name());
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditVariablesTableWidget::editVariableDialog(const QString &value)
+	{
+		int row = model()->rowByName(value);
+
+		if (row >= 0) {
+			auto lastData = model()->at(row);
+
+			if (lastData) {
+				QString lastName = lastData->ev_name();
+
+				EditVariablesDialog *dialog = new EditVariablesDialog(lastData, this);
+
+				if (dialog->exec() == QDialog::Accepted) {
+
+					auto newData = dialog->dbData();
+
+					if (newData) {
+
+						auto variablesModel = model();
+
+						auto newName = newData->ev_name();
+
+						if (variablesModel) {
+							int existingRow = variablesModel->rowByName(newName);
+
+							if (existingRow >= 0 && variablesModel->at(existingRow) != newData) {
+								newData->ev_name(lastName);
+								variablesModel->replace(row, newData);
+								Global::Messages::ErrorMessage(tr("Variable name ") + newName.trimmed() + tr(" is already exist!"));
+								return;
+							}
+
+							variablesModel->replace(row, newData);
+							emit editVariableSignal(lastName, newName);
+
+						}
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditVariablesTableWidget::removeVariable(const QString &value)
+	{		
+		int row = model()->rowByName(value);
+
+		if (row >= 0 && model()->at(row)) {
+			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
+
+				auto deletedName = model()->at(row)->ev_name();
+
+				model()->removeRow(row);
+
+				emit deleteVariableSignal(deletedName);
+			}
+
+		}
+		
+	}
+
+	
+	void EditVariablesTableWidget::onNewAction()
+	{
+		newVariableDialog();
+	}
+
+	void EditVariablesTableWidget::onOpenAction()
+	{
+		QModelIndex idx = currentIndex();
+
+		if (idx.isValid()) {
+
+			auto lastData = model()->at(idx.row());
+
+			if (lastData) {
+
+				QString lastName = lastData->ev_name();
+
+				EditVariablesDialog *dialog = new EditVariablesDialog(lastData, this);
+
+				if (dialog->exec() == QDialog::Accepted) {
+
+					auto newData = dialog->dbData();
+
+					if (newData) {
+
+						auto variablesModel = model();
+
+						auto newName = newData->ev_name();
+
+						if (variablesModel) {
+							int existingRow = variablesModel->rowByName(newName);
+
+							if (existingRow >= 0 && variablesModel->at(existingRow) != newData) {
+								newData->ev_name(lastName);
+								variablesModel->replace(idx.row(), newData);
+								Global::Messages::ErrorMessage(tr("Variable name ") + newName.trimmed() + tr(" is already exist!"));
+								return;
+							}
+
+							variablesModel->replace(idx.row(), newData);
+							emit editVariableSignal(lastName, newName);
+
+						}
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditVariablesTableWidget::onDeleteAction()
+	{
+		QModelIndex idx = currentIndex();
+
+		if (idx.isValid()) {
+
+			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
+				auto variablesModel = model();
+
+				if (variablesModel) {
+
+					auto deletedRec = variablesModel->at(idx.row());
+
+					variablesModel->removeRow(idx.row());
+
+					if (deletedRec) {
+
+						emit deleteVariableSignal(deletedRec->ev_name());
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditVariablesTableWidget::contextMenuEvent(QContextMenuEvent *e)
+	{
+		QTableView::contextMenuEvent(e);
+
+		QModelIndex cur = currentIndex();
+
+		QMenu contextMenu(tr("Context Menu"));
+
+		QAction *createAction = contextMenu.addAction(tr("New"));
+		QAction *editAction = contextMenu.addAction(tr("Edit"));
+		contextMenu.addSeparator();
+		QAction *deleteAction = contextMenu.addAction(tr("Delete"));
+
+		if (!cur.isValid()) {
+			editAction->setDisabled(true);
+			deleteAction->setDisabled(true);
+		}
+
+		QAction *selectedAction = contextMenu.exec(e->globalPos());
+
+		if (selectedAction == createAction)
+			onNewAction();
+		else if (selectedAction == editAction)
+			onOpenAction();
+		else if (selectedAction == deleteAction)
+			onDeleteAction();
+
+	}
+
+	// EditVariablesWidget
+	EditVariablesWidget::EditVariablesWidget(QWidget* parent)
+		: EditFilesVariablesWidgetBase(parent)
+	{
+		init();
+	}
+
+	EditVariablesWidget::EditVariablesWidget(const std::shared_ptr<emulation_dal::Emulation> data, QWidget* parent)
+		: EditFilesVariablesWidgetBase(parent)
+	{
+		init();
+
+		loadDBData(data);
+	}
+
+	void EditVariablesWidget::init()
+	{
+		EditFilesVariablesWidgetBase::setTableWidget(new EditVariablesTableWidget(this));
+
+		m_label->setText(tr("Scenery variables: "));
+
+		connect(m_toolbar->newAction(), SIGNAL(triggered(bool)), SLOT(onNewAction()));
+		connect(m_toolbar->editAction(), SIGNAL(triggered(bool)), SLOT(onOpenAction()));
+		connect(m_toolbar->removeAction(), SIGNAL(triggered(bool)), SLOT(onDeleteAction()));
+
+		connect(table(), SIGNAL(addVariableSignal(const QString &)), SIGNAL(addVariableSignal(const QString &)));
+		connect(table(), SIGNAL(editVariableSignal(const QString &, const QString &)), SIGNAL(editVariableSignal(const QString &, const QString &)));
+		connect(table(), SIGNAL(deleteVariableSignal(const QString &)), SIGNAL(deleteVariableSignal(const QString &)));
+	}
+
+	EditVariablesTableWidget *EditVariablesWidget::table() const
+	{
+		return dynamic_cast<EditVariablesTableWidget *>(EditFilesVariablesWidgetBase::tableWidget());
+	}
+
+	void EditVariablesWidget::tableData(const emulation_dal::Emulation_variable_store &value)
+	{
+		table()->setDataVector(value);
+	}
+
+	const emulation_dal::Emulation_variable_store &EditVariablesWidget::tableData() const
+	{
+		return table()->dataVector();
+	}
+
+	EditVariablesTableModel *EditVariablesWidget::tableModel() const
+	{
+		return table()->model();
+	}
+
+	void EditVariablesWidget::clear()
+	{
+		table()->clearDataVector();
+	}
+
+	void EditVariablesWidget::onNewAction()
+	{
+		table()->onNewAction();
+	}
+
+	void EditVariablesWidget::onOpenAction()
+	{
+		table()->onOpenAction();
+	}
+
+	void EditVariablesWidget::onDeleteAction()
+	{
+		table()->onDeleteAction();
+	}
+
+	void EditVariablesWidget::newVariableDialog()
+	{
+		table()->newVariableDialog();
+	}
+
+	void EditVariablesWidget::editVariableDialog(const QString &value)
+	{
+		table()->editVariableDialog(value);
+	}
+
+	void EditVariablesWidget::removeVariable(const QString &value)
+	{
+		table()->removeVariable(value);
+	}
+
+	void EditVariablesWidget::loadDBData(const std::shared_ptr<emulation_dal::Emulation> data)
+	{
+		if (data)
+			tableData(*data->emulation_variables());
+	}
+
+	// EditFilesTableWidget
+	EditFilesTableWidget::EditFilesTableWidget(QWidget *parent)
+		: EditFilesVariablesTableWidgetBase(parent)
+	{
+		init();
+	}
+
+	EditFilesTableWidget::EditFilesTableWidget(const std::shared_ptr<emulation_dal::Emulation> emulationData, QWidget *parent)
+		: EditFilesVariablesTableWidgetBase(parent)
+	{
+		init();
+
+		if (emulationData)
+			setDataVector(*emulationData->emulation_files());
+	}
+
+	void EditFilesTableWidget::init()
+	{
+		setModel(new EditFilesTableModel(this));
+
+		setItemDelegateForColumn(1, new VariableTypesListDelegate(this));
+		setItemDelegateForColumn(2, new VariableLenghtDelegate(this));
+
+		setSelectionBehavior(SelectRows);
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(horizontalHeader(), SIGNAL(geometriesChanged()), SLOT(saveSettings()));
+
+		enableGlobalActions();
+
+	}
+
+	void EditFilesTableWidget::setDataVector(const emulation_dal::Emulation_file_store &value)
+	{
+		auto filesModel = model();
+
+		if (filesModel)
+			filesModel->setDataVector(value);
+	}
+
+	const emulation_dal::Emulation_file_store &EditFilesTableWidget::dataVector() const
+	{
+		return *model();
+	}
+
+	void EditFilesTableWidget::clearDataVector()
+	{
+		auto filesModel = model();
+
+		if (filesModel)
+			model()->clearDataVector();
+	}
+
+	void EditFilesTableWidget::newFileDialog()
+	{
+		EditFilesDialog *dialog = new EditFilesDialog(this);
+		dialog->form()->fileStorePath(fileStorePath());
+
+		if (dialog->exec() == QDialog::Accepted) {
+			auto data = dialog->dbData();
+
+			if (data) {
+				auto filesModel = model();
+
+				if (filesModel) {
+					if (filesModel->containsName(data->ef_name())) {
+						Global::Messages::ErrorMessage(tr("File name ") + data->ef_name().trimmed() + tr(" is already exist!"));
+						return;
+					}
+
+					filesModel->push_back(data);
+					emit addFileSignal(data->ef_name());
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditFilesTableWidget::editFileDialog(const QString &value)
+	{
+		int row = model()->rowByName(value);
+
+		if (row >= 0) {
+
+			auto lastData = model()->at(row);
+
+			if (lastData) {
+				QString lastName = lastData->ef_name();
+
+				EditFilesDialog *dialog = new EditFilesDialog(lastData, this);
+				dialog->form()->fileStorePath(fileStorePath());
+
+				if (dialog->exec() == QDialog::Accepted) {
+					auto newData = dialog->dbData();
+
+					if (newData) {
+						auto filesModel = model();
+
+						auto newName = newData->ef_name();
+
+						if (filesModel) {
+							int existingRow = filesModel->rowByName(newName);
+
+							if (existingRow >= 0 && filesModel->at(existingRow) != newData) {
+								newData->ef_name(lastName);
+								filesModel->replace(row, newData);
+								Global::Messages::ErrorMessage(tr("File name ") + newName.trimmed() + tr(" is already exist!"));
+								return;
+							}
+
+							filesModel->replace(row, newData);
+							emit editFileSignal(lastName, newName);
+
+						}
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditFilesTableWidget::removeFile(const QString &value)
+	{
+		int row = model()->rowByName(value);
+
+		if (row >= 0 && model()->at(row)) {
+			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
+				auto deletedName = model()->at(row)->ef_name();
+				model()->removeRow(row);
+				emit deleteFileSignal(deletedName);
+
+			}
+
+		}
+
+	}
+
+	void EditFilesTableWidget::onNewAction()
+	{
+		newFileDialog();
+	}
+
+	void EditFilesTableWidget::onOpenAction()
+	{
+		QModelIndex idx = currentIndex();
+
+		if (idx.isValid()) {
+
+			auto lastData = model()->at(idx.row());
+
+			if (lastData) {
+
+				QString lastName = lastData->ef_name();
+
+				EditFilesDialog *dialog = new EditFilesDialog(lastData, this);
+				dialog->form()->fileStorePath(fileStorePath());
+
+				if (dialog->exec() == QDialog::Accepted) {
+
+					auto newData = dialog->dbData();
+
+					if (newData) {
+
+						auto filesModel = model();
+
+						auto newName = newData->ef_name();
+
+						if (filesModel) {
+							int existingRow = filesModel->rowByName(newName);
+
+							if (existingRow >= 0 && filesModel->at(existingRow) != newData) {
+								newData->ef_name(lastName);
+								filesModel->replace(idx.row(), newData);
+								Global::Messages::ErrorMessage(tr("File name ") + newName.trimmed() + tr(" is already exist!"));
+								return;
+							}
+
+							filesModel->replace(idx.row(), newData);
+							emit editFileSignal(lastName, newName);
+
+						}
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void EditFilesTableWidget::onDeleteAction()
+	{
+		QModelIndex idx = currentIndex();
+
+		if (idx.isValid()) {
+
+			if (Global::Messages::YesNoMessage(tr("Delete current record?"), tr("Deleting record")) == QMessageBox::Yes) {
+				auto filesModel = model();
+
+				if (filesModel) {
+					auto deletedRec = filesModel->at(idx.row());
+
+					filesModel->removeRow(idx.row());
+
+					emit deleteFileSignal(deletedRec->ef_name());
+
+				}
+
+			}
+
+		}
+
+	}
+
+	QString EditFilesTableWidget::fileStorePath() const
+	{
+		auto filesWidget = dynamic_cast<EditFilesWidget *>(parentWidget());
+
+		if (filesWidget && filesWidget->useFileStore())
+			return filesWidget->fileStorePath();
+
+		return QString();
+	}
+
+	void EditFilesTableWidget::contextMenuEvent(QContextMenuEvent *e)
+	{
+		QTableView::contextMenuEvent(e);
+
+		QModelIndex cur = currentIndex();
+
+		QMenu contextMenu(tr("Context Menu"));
+
+		QAction *createAction = contextMenu.addAction(tr("New"));
+		QAction *editAction = contextMenu.addAction(tr("Edit"));
+		contextMenu.addSeparator();
+		QAction *deleteAction = contextMenu.addAction(tr("Delete"));
+
+		if (!cur.isValid()) {
+			editAction->setDisabled(true);
+			deleteAction->setDisabled(true);
+		}
+
+		QAction *selectedAction = contextMenu.exec(e->globalPos());
+
+		if (selectedAction == createAction)
+			onNewAction();
+		else if (selectedAction == editAction)
+			onOpenAction();
+		else if (selectedAction == deleteAction)
+			onDeleteAction();
+	}
+
+	// EditFilesWidget
+	EditFilesWidget::EditFilesWidget(QWidget* parent)
+		: EditFilesVariablesWidgetBase(parent)
+	{
+		init();
+
+	}
+
+	EditFilesWidget::EditFilesWidget(const std::shared_ptr<emulation_dal::Emulation> data, QWidget* parent)
+		: EditFilesVariablesWidgetBase(parent)
+	{
+		init();
+
+		loadDBData(data);
+
+	}
+
+	void EditFilesWidget::init()
+	{
+		QHBoxLayout *fileStoreLayout = new QHBoxLayout();
+
+		m_useFileStoreCheckBox = new CheckBox(tr("Use file store"));
+		m_layout->addWidget(m_useFileStoreCheckBox);
+
+		m_fileStorePath = new QLineEdit();
+		m_fileStorePath->setPlaceholderText(tr("File store root directory"));
+		m_fileStorePath->setToolTip(tr("Files are stored once under their SHA-256 checksum in the objects subdirectory and shared by all sceneries using this root"));
+
+		fileStoreLayout->addWidget(m_useFileStoreCheckBox);
+		fileStoreLayout->addWidget(m_fileStorePath);
+
+		m_layout->addLayout(fileStoreLayout);
+
+		EditFilesVariablesWidgetBase::setTableWidget(new EditFilesTableWidget(this));
+
+		m_label->setText(tr("Scenery files: "));
+
+		connect(m_toolbar->newAction(), SIGNAL(triggered(bool)), SLOT(onNewAction()));
+		connect(m_toolbar->editAction(), SIGNAL(triggered(bool)), SLOT(onOpenAction()));
+		connect(m_toolbar->removeAction(), SIGNAL(triggered(bool)), SLOT(onDeleteAction()));
+
+		connect(table(), SIGNAL(addFileSignal(const QString &)), SIGNAL(addFileSignal(const QString &)));
+		connect(table(), SIGNAL(editFileSignal(const QString &, const QString &)), SIGNAL(editFileSignal(const QString &, const QString &)));
+		connect(table(), SIGNAL(deleteFileSignal(const QString &)), SIGNAL(deleteFileSignal(const QString &)));
+
+		connect(m_useFileStoreCheckBox, SIGNAL(stateChanged(int)), SLOT(updateFileStoreAccesibility()));
+		connect(m_fileStorePath, SIGNAL(textChanged(const QString &)), SLOT(updateFileStore()));
+
+		updateFileStoreAccesibility();
+
+	}
+
+	EditFilesTableWidget *EditFilesWidget::table() const
+	{
+		return dynamic_cast<EditFilesTableWidget *>(EditFilesVariablesWidgetBase::tableWidget());
+	}
+
+	bool EditFilesWidget::useFileStore() const
+	{
+		return m_useFileStoreCheckBox->isChecked();
+	}
+
+	void EditFilesWidget::useFileStore(const bool value)
+	{
+		m_useFileStoreCheckBox->setChecked(value);
+	}
+
+	QString EditFilesWidget::fileStorePath() const
+	{
+		return m_fileStorePath->text();
+	}
+
+	void EditFilesWidget::fileStorePath(const QString &value)
+	{
+		m_fileStorePath->setText(value);
+	}
+
+	void EditFilesWidget::tableData(const emulation_dal::Emulation_file_store &value)
+	{
+		table()->setDataVector(value);
+	}
+
+	const emulation_dal::Emulation_file_store &EditFilesWidget::tableData() const
+	{
+		return table()->dataVector();
+	}
+
+	EditFilesTableModel *EditFilesWidget::tableModel() const
+	{
+		return table()->model();
+	}
+
+	void EditFilesWidget::newVariableDialog()
+	{
+		table()->newFileDialog();
+	}
+
+	void EditFilesWidget::editVariableDialog(const QString &value)
+	{
+		table()->editFileDialog(value);
+	}
+
+	void EditFilesWidget::removeVariable(const QString &value)
+	{
+		table()->removeFile(value);
+	}
+
+	void EditFilesWidget::clear()
+	{
+		table()->clearDataVector();
+	}
+
+	void EditFilesWidget::onNewAction()
+	{
+		table()->onNewAction();
+	}
+
+	void EditFilesWidget::onOpenAction()
+	{
+		table()->onOpenAction();
+	}
+
+	void EditFilesWidget::onDeleteAction()
+	{
+		table()->onDeleteAction();
+	}
+
+	void EditFilesWidget::updateFileStoreAccesibility()
+	{
+		m_fileStorePath->setEnabled(useFileStore());
+	}
+
+	void EditFilesWidget::updateFileStore()
+	{
+		tableModel()->fileStore(EmulationFileStore(fileStorePath()));
+	}
+
+	void EditFilesWidget::loadDBData(const std::shared_ptr<emulation_dal::Emulation> data)
+	{
+		if (data) {
+			tableData(*data->emulation_files());
+			useFileStore(data->emulation_use_file_store());
+			fileStorePath(data->emulation_file_store_path());
+			
+			updateFileStoreAccesibility();
+		}
+
+	}
+
+	// DVFSplitterBase
+	DVFSplitterBase::DVFSplitterBase(WidgetBase* parent)
+		: QSplitter(parent), ParentWidget(parent)
+	{
+		init();
+	}
+
+	void DVFSplitterBase::init()
+	{
+		QLabel *descriptionLabel = new QLabel(tr("Description:"));
+		m_descriptionEdit = new PlainTextEdit();
+
+		QWidget *descriptionWidget = new QWidget();
+		QVBoxLayout *descriptionLayout = new QVBoxLayout();
+		descriptionLayout->setContentsMargins(0, 0, 0, 0);
+		descriptionWidget->setLayout(descriptionLayout);
+
+		descriptionLayout->addWidget(descriptionLabel);
+		descriptionLayout->addWidget(m_descriptionEdit);
+
+		setOrientation(Qt::Vertical);
+		setContentsMargins(0, 0, 0, 0);
+
+		addWidget(descriptionWidget);
+
+		EmulationSession::attach(m_parentContainerWidget);
+
+		connect(EmulationNotifyDispatcher::instance(), SIGNAL(emulationUpdated(const NotifyEvent &)), SLOT(update(const NotifyEvent &)));
+
+	}
+
+	void DVFSplitterBase::description(const QString& value)
+	{
+		m_descriptionEdit->setPlainText(value);
+	}
+
+	QString DVFSplitterBase::description() const
+	{
+		return m_descriptionEdit->toPlainText();
+	}
+
+	void DVFSplitterBase::clear()
+	{
+		m_descriptionEdit->clear();
+	}
+
+	void DVFSplitterBase::loadDBData()
+	{
+		clear();
+
+		auto data = dbData();
+
+		if (data) {
+			description(data->emulation_description());
+		}
+
+	}
+
+	void DVFSplitterBase::updateDBData()
+	{
+		auto data = dbData();
+
+		if (data)
+			data->emulation_description(description());
+	}
+
+	void DVFSplitterBase::update(const NotifyEvent &ev)
+	{
+		auto data = dbData();
+
+		if (data && data->id() == ev.objectId()) {
+			auto emulation = EmulationNotifyDispatcher::instance()->emulation(ev);
+
+			if (emulation)
+				description(emulation->emulation_description());
+		}
+
+	}
+
+	// EmulationSnapshot
+	std::shared_ptr<EmulationSnapshot> EmulationSnapshot::load(const long emulationId, const Parts requestedParts, const std::shared_ptr<QAtomicInt> &cancelFlag,
+		const QString &cachedDigest, const QSet<long> &countedCanvases)
+	{
+		auto snapshot = std::make_shared<EmulationSnapshot>();
+
+		snapshot->emulationId = emulationId;
+		snapshot->requestedParts = requestedParts;
+
+		Parts parts = requestedParts;
+
+		try {
+			odb::transaction transaction(emulation_dal::DB::database()->begin());
+
+			odb::database &db = transaction.database();
+
+			snapshot->emulation = QueryByIdCache<emulation_dal::Emulation_store>::fetch(emulationId);
+
+			if (!snapshot->emulation || cancelFlag->load())
+				return snapshot;
+
+			snapshot->updateTime = snapshot->emulation->emulation_update_time();
+
+			if (parts.testFlag(Variables) && parts.testFlag(Files)) {
+				snapshot->digest = digest(db, emulationId);
+
+				if (!cachedDigest.isEmpty() && cachedDigest == snapshot->digest) {
+					snapshot->confirmedParts = parts & (Variables | Files);
+					parts &= ~(Variables | Files);
+				}
+			}
+
+			if (parts.testFlag(Variables)) {
+				typedef odb::query<EmulationVariableRow> query;
+
+				snapshot->variables = EmulationSnapshot::query<EmulationVariableRowStore>(db, query::emulation == query::_val(emulationId));
+				snapshot->parts |= Variables;
+			}
+
+			if (parts.testFlag(Files) && !cancelFlag->load()) {
+				typedef odb::query<EmulationFileRow> query;
+
+				snapshot->files = EmulationSnapshot::query<EmulationFileRowStore>(db, query::emulation == query::_val(emulationId));
+				snapshot->parts |= Files;
+			}
+
+			if (parts.testFlag(TopologyHosts) && !cancelFlag->load()) {
+				typedef odb::query<emulation_dal::Emulation_topology_host> query;
+
+				snapshot->canvas = snapshot->emulation->etc();
+
+				if (!snapshot->canvas)
+					snapshot->topologyHosts = std::make_shared<emulation_dal::Emulation_topology_host_store>();
+				else if (!countedCanvases.contains(snapshot->canvas->id()))
+					snapshot->topologyHosts = EmulationSnapshot::query<emulation_dal::Emulation_topology_host_store>(db, query::etc == query::_val(snapshot->canvas->id()));
+
+				snapshot->parts |= TopologyHosts;
+			}
+
+			if (parts.testFlag(RuntimeRequests) && !cancelFlag->load()) {
+				snapshot->runtimeRequests = EmulationSnapshot::query<emulation_dal::Emulation_runtime_request_store>(db,
+					EmulationRuntimeRequestsModel::pageQuery(emulationId, RuntimeRequestsFilter(), 0, QDateTime()));
+				snapshot->parts |= RuntimeRequests;
+			}
+
+			transaction.commit();
+		}
+		catch (const odb::exception &e) {
+			snapshot->parts = Parts();
+			snapshot->confirmedParts = Parts();
+			snapshot->error = QString::fromLocal8Bit(e.what());
+		}
+
+		if (snapshot->parts.testFlag(Variables) && snapshot->parts.testFlag(Files) && !cancelFlag->load())
+			EmulationSnapshotCache::write(*snapshot);
+
+		return snapshot;
+	}
+
+	QString EmulationSnapshot::digest(odb::database &db, const long emulationId)
+	{
+		typedef odb::query<EmulationVariablesDigest> variablesQuery;
+		typedef odb::query<EmulationFilesDigest> filesQuery;
+
+		auto variables = db.query_value<EmulationVariablesDigest>(variablesQuery::emulation == variablesQuery::_val(emulationId));
+		auto files = db.query_value<EmulationFilesDigest>(filesQuery::emulation == filesQuery::_val(emulationId));
+
+		return QString("%1:%2:%3/%4:%5:%6").arg(variables.count).arg(variables.maxId).arg(variables.checksum)
+			.arg(files.count).arg(files.maxId).arg(files.checksum);
+	}
+
+	// EmulationSnapshotCache
+	QString EmulationSnapshotCache::directory()
+	{
+		return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/emulation_snapshots";
+	}
+
+	QString EmulationSnapshotCache::fileName(const long emulationId)
+	{
+		return directory() + QString("/%1.snapshot").arg(emulationId);
+	}
+
+	std::shared_ptr<EmulationSnapshot> EmulationSnapshotCache::read(const long emulationId)
+	{
+		QFile file(fileName(emulationId));
+
+		if (!file.open(QIODevice::ReadOnly))
+			return nullptr;
+
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		quint32 magic = 0;
+		quint16 version = 0;
+		qint64 id = 0;
+
+		stream >> magic >> version >> id;
+
+		if (magic != Magic || version != FormatVersion || id != emulationId)
+			return nullptr;
+
+		auto snapshot = std::make_shared<EmulationSnapshot>();
+
+		snapshot->emulationId = emulationId;
+		snapshot->cached = true;
+		snapshot->variables = std::make_shared<EmulationVariableRowStore>();
+		snapshot->files = std::make_shared<EmulationFileRowStore>();
+
+		quint32 count = 0;
+
+		stream >> snapshot->updateTime >> snapshot->digest >> count;
+
+		for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+			auto row = std::make_shared<EmulationVariableRow>();
+			qint64 recordId = 0, rowEmulationId = 0, typeId = 0, length = 0;
+			bool lengthNull = true;
+
+			stream >> recordId >> rowEmulationId >> row->name >> typeId >> lengthNull >> length >> row->description
+				>> row->dataReady >> row->dataSize >> row->dataPrefix >> row->dataHash;
+
+			row->recordId = recordId;
+			row->emulationId = rowEmulationId;
+			row->typeId = typeId;
+
+			if (!lengthNull)
+				row->length = length;
+
+			snapshot->variables->push_back(row);
+		}
+
+		stream >> count;
+
+		for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+			auto row = std::make_shared<EmulationFileRow>();
+			qint64 recordId = 0, rowEmulationId = 0, typeId = 0;
+
+			stream >> recordId >> rowEmulationId >> row->name >> typeId >> row->dataReady >> row->useFileStore >> row->description
+				>> row->dataSize >> row->dataPrefix >> row->dataHash;
+
+			row->recordId = recordId;
+			row->emulationId = rowEmulationId;
+			row->typeId = typeId;
+
+			snapshot->files->push_back(row);
+		}
+
+		if (stream.status() != QDataStream::Ok || snapshot->digest.isEmpty()) {
+			file.close();
+			remove(emulationId);
+
+			return nullptr;
+		}
+
+		snapshot->parts = EmulationSnapshot::Variables | EmulationSnapshot::Files;
+
+		//       .  Windows  
+		//   ,   ,      
+		file.close();
+
+		if (file.open(QIODevice::ReadWrite))
+			file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+		return snapshot;
+	}
+
+	bool EmulationSnapshotCache::write(const EmulationSnapshot &snapshot)
+	{
+		if (!snapshot.variables || !snapshot.files || snapshot.digest.isEmpty() || !QDir().mkpath(directory()))
+			return false;
+
+		QSaveFile file(fileName(snapshot.emulationId));
+
+		if (!file.open(QIODevice::WriteOnly))
+			return false;
+
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		stream << Magic << FormatVersion << static_cast<qint64>(snapshot.emulationId) << snapshot.updateTime << snapshot.digest;
+
+		stream << static_cast<quint32>(snapshot.variables->size());
+
+		for (auto row : *snapshot.variables) {
+			stream << static_cast<qint64>(row->recordId) << static_cast<qint64>(row->emulationId) << row->name << static_cast<qint64>(row->typeId)
+				<< row->length.null() << static_cast<qint64>(row->length.null() ? 0 : row->length.get()) << row->description
+				<< row->dataReady << row->dataSize << row->dataPrefix << row->dataHash;
+		}
+
+		stream << static_cast<quint32>(snapshot.files->size());
+
+		for (auto row : *snapshot.files) {
+			stream << static_cast<qint64>(row->recordId) << static_cast<qint64>(row->emulationId) << row->name << static_cast<qint64>(row->typeId)
+				<< row->dataReady << row->useFileStore << row->description << row->dataSize << row->dataPrefix << row->dataHash;
+		}
+
+		if (stream.status() != QDataStream::Ok || !file.commit())
+			return false;
+
+		prune();
+
+		return true;
+	}
+
+	void EmulationSnapshotCache::remove(const long emulationId)
+	{
+		QFile::remove(fileName(emulationId));
+	}
+
+	void EmulationSnapshotCache::prune()
+	{
+		auto entries = QDir(directory()).entryInfoList(QStringList() << "*.snapshot", QDir::Files, QDir::Time);
+
+		for (int i = MaxEntries; i < entries.size(); ++i)
+			QFile::remove(entries[i].absoluteFilePath());
+	}
+
+	// EmulationSnapshotLoader
+	EmulationSnapshotLoader::EmulationSnapshotLoader(QObject *container)
+		: QObject(container), m_loadingId(0), m_requestedId(0)
+	{
+		m_cacheWatcher = new QFutureWatcher<std::shared_ptr<EmulationSnapshot>>(this);
+		connect(m_cacheWatcher, SIGNAL(finished()), SLOT(cacheRead()));
+
+		m_watcher = new QFutureWatcher<std::shared_ptr<EmulationSnapshot>>(this);
+		connect(m_watcher, SIGNAL(finished()), SLOT(loadFinished()));
+
+		m_startTimer = new QTimer(this);
+		m_startTimer->setSingleShot(true);
+		m_startTimer->setInterval(0);
+		connect(m_startTimer, SIGNAL(timeout()), SLOT(start()));
+	}
+
+	EmulationSnapshotLoader *EmulationSnapshotLoader::attach(QObject *container)
+	{
+		if (!container)
+			return nullptr;
+
+		auto existing = container->findChild<EmulationSnapshotLoader *>(QString(), Qt::FindDirectChildrenOnly);
+
+		if (existing)
+			return existing;
+
+		return new EmulationSnapshotLoader(container);
+	}
+
+	EmulationSnapshotLoader *EmulationSnapshotLoader::of(const QObject *object)
+	{
+		for (; object; object = object->parent()) {
+			auto loader = object->findChild<EmulationSnapshotLoader *>(QString(), Qt::FindDirectChildrenOnly);
+
+			if (loader)
+				return loader;
+		}
+
+		return nullptr;
+	}
+
+	void EmulationSnapshotLoader::load(const long emulationId, const EmulationSnapshot::Parts parts)
+	{
+		if (emulationId != m_requestedId) {
+			m_requestedId = emulationId;
+			m_requestedParts = parts;
+		}
+		else
+			m_requestedParts |= parts;
+
+		m_startTimer->start();
+	}
+
+	bool EmulationSnapshotLoader::isLoading() const
+	{
+		return m_loadingId || m_startTimer->isActive();
+	}
+
+	void EmulationSnapshotLoader::start()
+	{
+		if (!m_requestedId)
+			return;
+
+		if (m_loadingId == m_requestedId && (m_loadingParts & m_requestedParts) == m_requestedParts) {
+			m_requestedId = 0;
+			return;
+		}
+
+		EmulationSnapshot::Parts parts = m_requestedParts;
+
+		if (m_loadingId == m_requestedId)
+			parts |= m_loadingParts;
+
+		if (m_cancelFlag)
+			m_cancelFlag->store(1);
+
+		const long emulationId = m_requestedId;
+		auto cancelFlag = m_cancelFlag = std::make_shared<QAtomicInt>(0);
+
+		m_loadingId = emulationId;
+		m_loadingParts = parts;
+		m_requestedId = 0;
+
+		m_watcher->setFuture(QFuture<std::shared_ptr<EmulationSnapshot>>());
+
+		if (parts.testFlag(EmulationSnapshot::Variables) && parts.testFlag(EmulationSnapshot::Files)) {
+			m_cacheWatcher->setFuture(QtConcurrent::run([emulationId]() {
+				return EmulationSnapshotCache::read(emulationId);
+			}));
+		}
+		else {
+			m_cacheWatcher->setFuture(QFuture<std::shared_ptr<EmulationSnapshot>>());
+
+			startLoading(QString());
+		}
+	}
+
+	void EmulationSnapshotLoader::cacheRead()
+	{
+		if (!m_cacheWatcher->future().resultCount() || !m_loadingId)
+			return;
+
+		auto cached = m_cacheWatcher->result();
+
+		m_cacheWatcher->setFuture(QFuture<std::shared_ptr<EmulationSnapshot>>());
+
+		startLoading(cached ? cached->digest : QString());
+
+		if (cached)
+			emit loaded(cached);
+	}
+
+	void EmulationSnapshotLoader::startLoading(const QString &cachedDigest)
+	{
+		const long emulationId = m_loadingId;
+		const EmulationSnapshot::Parts parts = m_loadingParts;
+		auto cancelFlag = m_cancelFlag;
+
+		const QSet<long> countedCanvases = parts.testFlag(EmulationSnapshot::TopologyHosts) ? TopologyHostsCounter::instance()->loadedCanvases() : QSet<long>();
+
+		m_watcher->setFuture(QtConcurrent::run([emulationId, parts, cancelFlag, cachedDigest, countedCanvases]() {
+			return EmulationSnapshot::load(emulationId, parts, cancelFlag, cachedDigest, countedCanvases);
+		}));
+	}
+
+	void EmulationSnapshotLoader::loadFinished()
+	{
+		//        ,    
+		if (!m_watcher->future().resultCount())
+			return;
+
+		auto snapshot = m_watcher->result();
+
+		//  ,   QFuture, ,      
+		m_watcher->setFuture(QFuture<std::shared_ptr<EmulationSnapshot>>());
+
+		m_loadingId = 0;
+		m_cancelFlag.reset();
+
+		if (!snapshot)
+			return;
+
+		if (!snapshot->error.isEmpty())
+			Global::Messages::ErrorMessage(tr("Emulation data loading error: ") + snapshot->error);
+
+		emit loaded(snapshot);
+	}
+
+	// ViewDVFSplitter
+	ViewDVFSplitter::ViewDVFSplitter(WidgetBase* parent)
+		: DVFSplitterBase(parent), m_loadingId(0), m_variablesOffset(0), m_filesOffset(0), m_showingCache(false)
+	{
+		init();
+	}
+
+	void ViewDVFSplitter::init()
+	{
+		//   
+		m_variablesWidget = new ViewVariablesWidget(this);
+		addWidget(m_variablesWidget);
+
+		//   
+		m_filesWidget = new ViewFilesWidget(this);
+		addWidget(m_filesWidget);
+
+		m_descriptionEdit->setReadOnly(true);
+
+		connect(EmulationSnapshotLoader::attach(m_parentContainerWidget), SIGNAL(loaded(const std::shared_ptr<EmulationSnapshot> &)),
+			SLOT(snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &)));
+
+		m_chunkTimer = new QTimer(this);
+		m_chunkTimer->setInterval(0);
+		connect(m_chunkTimer, SIGNAL(timeout()), SLOT(loadNextChunk()));
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(this, SIGNAL(splitterMoved(int, int)), SLOT(saveSettings()));
+
+	}
+
+	void ViewDVFSplitter::clear()
+	{
+		cancelLoading();
+
+		DVFSplitterBase::clear();
+
+		m_variablesWidget->clear();
+		m_filesWidget->clear();
+	}
+
+	void ViewDVFSplitter::variablesData(const emulation_dal::Emulation_variable_store &value)
+	{
+		m_variablesWidget->tableData(value);
+	}
+
+	void ViewDVFSplitter::filesData(const emulation_dal::Emulation_file_store &value)
+	{
+		m_filesWidget->tableData(value);
+	}
+
+	ViewVariablesTableModel *ViewDVFSplitter::model() const
+	{
+		return m_variablesWidget->tableModel();
+	}
+
+	void ViewDVFSplitter::setEditable(const bool flag)
+	{
+		m_descriptionEdit->setEnabled(flag);
+	}
+
+	void ViewDVFSplitter::loadDBData()
+	{
+		clear();
+
+		DVFSplitterBase::loadDBData();
+
+		auto data = dbData();
+
+		if (data) {
+			m_filesWidget->useFileStore(data->emulation_use_file_store(), data->emulation_file_store_path());
+
+			EmulationNotifyDispatcher::instance()->subscribe(this, data->id());
+
+			auto loader = EmulationSnapshotLoader::attach(m_parentContainerWidget);
+
+			if (loader) {
+				m_loadingId = data->id();
+
+				loader->load(data->id(), EmulationSnapshot::Variables | EmulationSnapshot::Files);
+			}
+		}
+		else
+			EmulationNotifyDispatcher::instance()->unsubscribe(this);
+
+	}
+
+	bool ViewDVFSplitter::isLoading() const
+	{
+		return m_loadingId || m_chunkTimer->isActive();
+	}
+
+	void ViewDVFSplitter::cancelLoading()
+	{
+		m_loadingId = 0;
+		m_showingCache = false;
+		m_chunkTimer->stop();
+
+		m_pendingVariables.reset();
+		m_pendingFiles.reset();
+		m_variablesOffset = 0;
+		m_filesOffset = 0;
+
+		m_changedVariables.clear();
+		m_changedFiles.clear();
+	}
+
+	void ViewDVFSplitter::snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot)
+	{
+		const EmulationSnapshot::Parts parts = EmulationSnapshot::Variables | EmulationSnapshot::Files;
+
+		if (!m_loadingId || snapshot->emulationId != m_loadingId)
+			return;
+
+		if (snapshot->failed(EmulationSnapshot::Variables)) {
+			loadFailed();
+			return;
+		}
+
+		if (m_showingCache && (snapshot->confirmedParts & parts) == parts) {
+			m_loadingId = 0;
+			m_showingCache = false;
+
+			m_changedVariables.clear();
+			m_changedFiles.clear();
+
+			if (!m_chunkTimer->isActive())
+				emit loaded();
+
+			return;
+		}
+
+		if ((snapshot->parts & parts) != parts)
+			return;
+
+		if (snapshot->cached) {
+			m_showingCache = true;
+		}
+		else {
+			m_loadingId = 0;
+
+			if (m_showingCache) {
+				m_showingCache = false;
+				m_chunkTimer->stop();
+
+				m_variablesWidget->clear();
+				m_filesWidget->clear();
+			}
+		}
+
+		m_pendingVariables = std::move(snapshot->variables);
+		m_pendingFiles = std::move(snapshot->files);
+
+		if (!m_pendingVariables)
+			m_pendingVariables = std::make_shared<EmulationVariableRowStore>();
+
+		if (!m_pendingFiles)
+			m_pendingFiles = std::make_shared<EmulationFileRowStore>();
+
+		EmulationNotifyDispatcher::instance()->registerVariables(*m_pendingVariables, snapshot->emulationId);
+		EmulationNotifyDispatcher::instance()->registerFiles(*m_pendingFiles, snapshot->emulationId);
+
+		m_variablesOffset = 0;
+		m_filesOffset = 0;
+
+		// ,    ,       
+		dropChanged(*m_pendingVariables, 0, m_changedVariables, m_variablesWidget->tableModel());
+		dropChanged(*m_pendingFiles, 0, m_changedFiles, m_filesWidget->tableModel());
+
+		if (!snapshot->cached) {
+			m_changedVariables.clear();
+			m_changedFiles.clear();
+		}
+
+		m_chunkTimer->start();
+	}
+
+	void ViewDVFSplitter::loadNextChunk()
+	{
+		if (m_variablesOffset < m_pendingVariables->size()) {
+			auto first = m_pendingVariables->begin() + m_variablesOffset;
+			auto count = std::min<size_t>(LoadChunkSize, m_pendingVariables->size() - m_variablesOffset);
+
+			EmulationVariableRowStore chunk;
+			chunk.insert(chunk.end(), std::make_move_iterator(first), std::make_move_iterator(first + count));
+
+			m_variablesWidget->tableModel()->appendRecords(std::move(chunk));
+			m_variablesOffset += count;
+		}
+		else if (m_filesOffset < m_pendingFiles->size()) {
+			auto first = m_pendingFiles->begin() + m_filesOffset;
+			auto count = std::min<size_t>(LoadChunkSize, m_pendingFiles->size() - m_filesOffset);
+
+			EmulationFileRowStore chunk;
+			chunk.insert(chunk.end(), std::make_move_iterator(first), std::make_move_iterator(first + count));
+
+			m_filesWidget->tableModel()->appendRecords(std::move(chunk));
+			m_filesOffset += count;
+		}
+
+		if (m_variablesOffset >= m_pendingVariables->size() && m_filesOffset >= m_pendingFiles->size()) {
+			m_chunkTimer->stop();
+			m_pendingVariables.reset();
+			m_pendingFiles.reset();
+			m_variablesOffset = 0;
+			m_filesOffset = 0;
+
+			if (!m_loadingId) {
+				m_changedVariables.clear();
+				m_changedFiles.clear();
+
+				emit loaded();
+			}
+		}
+	}
+
+	void ViewDVFSplitter::appendVariable(const NotifyEvent &ev)
+	{
+		m_variablesWidget->tableModel()->coalescer()->append(ev.objectId());
+	}
+
+	void ViewDVFSplitter::loadFailed()
+	{
+		cancelLoading();
+
+		m_variablesWidget->clear();
+		m_filesWidget->clear();
+
+		auto data = dbData();
+
+		if (data) {
+			try {
+				variablesData(*data->emulation_variables());
+				filesData(*data->emulation_files());
+
+				EmulationNotifyDispatcher::instance()->registerVariables(*m_variablesWidget->tableModel(), data->id());
+				EmulationNotifyDispatcher::instance()->registerFiles(*m_filesWidget->tableModel(), data->id());
+			}
+			catch (const odb::exception &) {
+				m_variablesWidget->clear();
+				m_filesWidget->clear();
+			}
+		}
+
+		emit loaded();
+	}
+
+	void ViewDVFSplitter::updateVariable(const NotifyEvent &ev)
+	{
+		m_variablesWidget->tableModel()->coalescer()->update(ev.objectId());
+
+		variableChanged(ev.objectId());
+	}
+
+	void ViewDVFSplitter::removeVariable(const NotifyEvent &ev)
+	{
+		m_variablesWidget->tableModel()->coalescer()->remove(ev.objectId());
+
+		variableChanged(ev.objectId());
+	}
+
+	void ViewDVFSplitter::appendFile(const NotifyEvent &ev)
+	{
+		m_filesWidget->tableModel()->coalescer()->append(ev.objectId());
+	}
+
+	void ViewDVFSplitter::updateFile(const NotifyEvent &ev)
+	{
+		m_filesWidget->tableModel()->coalescer()->update(ev.objectId());
+
+		fileChanged(ev.objectId());
+	}
+	
+	void ViewDVFSplitter::removeFile(const NotifyEvent &ev)
+	{
+		m_filesWidget->tableModel()->coalescer()->remove(ev.objectId());
+
+		fileChanged(ev.objectId());
+	}
+
+	void ViewDVFSplitter::variableChanged(const long id)
+	{
+		if (!isLoading())
+			return;
+
+		m_changedVariables.insert(id);
+
+		if (m_pendingVariables)
+			dropChanged(*m_pendingVariables, m_variablesOffset, QSet<long>() << id, m_variablesWidget->tableModel());
+	}
+
+	void ViewDVFSplitter::fileChanged(const long id)
+	{
+		if (!isLoading())
+			return;
+
+		m_changedFiles.insert(id);
+
+		if (m_pendingFiles)
+			dropChanged(*m_pendingFiles, m_filesOffset, QSet<long>() << id, m_filesWidget->tableModel());
+	}
+
+	// EmulationNotifyDispatcher
+	EmulationNotifyDispatcher::EmulationNotifyDispatcher(QObject *parent)
+		: QObject(parent), m_emulationDispatching(false), m_emulationFetched(false), m_emulationId(0), m_savedQueriesCount(0)
+	{
+		init();
+	}
+
+	EmulationNotifyDispatcher *EmulationNotifyDispatcher::instance()
+	{
+		static EmulationNotifyDispatcher *dispatcher = new EmulationNotifyDispatcher(qApp);
+
+		return dispatcher;
+	}
+
+	void EmulationNotifyDispatcher::init()
+	{
+		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(appendVariable(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateVariable(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_variable_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(removeVariable(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(appendFile(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateFile(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_file_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(removeFile(const NotifyEvent &)));
+
+		connect(emulation_dal::DB::notifier()->Emulation_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateEmulation(const NotifyEvent &)));
+	}
+
+	void EmulationNotifyDispatcher::updateEmulation(const NotifyEvent &ev)
+	{
+		m_emulationDispatching = true;
+		m_emulationFetched = false;
+		m_emulationId = ev.objectId();
+
+		emit emulationUpdated(ev);
+
+		m_emulationDispatching = false;
+		m_emulationFetched = false;
+		m_emulation.reset();
+	}
+
+	std::shared_ptr<emulation_dal::Emulation> EmulationNotifyDispatcher::emulation(const NotifyEvent &ev)
+	{
+		if (m_emulationDispatching && m_emulationId == ev.objectId()) {
+			if (m_emulationFetched)
+				++m_savedQueriesCount;
+			else {
+				m_emulation = QueryByIdCache<emulation_dal::Emulation_store>::fetch(ev.objectId());
+				m_emulationFetched = true;
+			}
+
+			return m_emulation;
+		}
+
+		return QueryByIdCache<emulation_dal::Emulation_store>::fetch(ev.objectId());
+	}
+
+	int EmulationNotifyDispatcher::savedQueriesCount() const
+	{
+		return m_savedQueriesCount;
+	}
+
+	void EmulationNotifyDispatcher::subscribe(ViewDVFSplitter *splitter, const long emulationId)
+	{
+		if (!splitter)
+			return;
+
+		auto it = m_subscriptions.find(splitter);
+
+		if (it != m_subscriptions.end()) {
+			if (it.value() == emulationId)
+				return;
+
+			unsubscribe(splitter);
+		}
+		else
+			connect(splitter, SIGNAL(destroyed(QObject *)), SLOT(splitterDestroyed(QObject *)));
+
+		m_subscriptions.insert(splitter, emulationId);
+		m_subscribers.insert(emulationId, splitter);
+	}
+
+	void EmulationNotifyDispatcher::unsubscribe(ViewDVFSplitter *splitter)
+	{
+		auto it = m_subscriptions.find(splitter);
+
+		if (it != m_subscriptions.end()) {
+			auto emulationId = it.value();
+
+			m_subscriptions.erase(it);
+			m_subscribers.remove(emulationId, splitter);
+
+			if (!m_subscribers.contains(emulationId))
+				releaseOwners(emulationId);
+		}
+	}
+
+	void EmulationNotifyDispatcher::splitterDestroyed(QObject *object)
+	{
+		//       ,     
+		for (auto i : m_subscriptions.keys()) {
+			if (static_cast<QObject *>(i) == object) {
+				unsubscribe(i);
+				break;
+			}
+		}
+	}
+
+	void EmulationNotifyDispatcher::registerVariables(const EmulationVariableRowStore &value, const long emulationId)
+	{
+		for (auto i : value) {
+			if (i)
+				m_variableOwners.insert(i->id(), emulationId);
+		}
+	}
+
+	void EmulationNotifyDispatcher::registerFiles(const EmulationFileRowStore &value, const long emulationId)
+	{
+		for (auto i : value) {
+			if (i)
+				m_fileOwners.insert(i->id(), emulationId);
+		}
+	}
+
+	void EmulationNotifyDispatcher::releaseOwners(const long emulationId)
+	{
+		for (auto it = m_variableOwners.begin(); it != m_variableOwners.end();) {
+			if (it.value() == emulationId)
+				it = m_variableOwners.erase(it);
+			else
+				++it;
+		}
+
+		for (auto it = m_fileOwners.begin(); it != m_fileOwners.end();) {
+			if (it.value() == emulationId)
+				it = m_fileOwners.erase(it);
+			else
+				++it;
+		}
+	}
+
+	void EmulationNotifyDispatcher::appendVariable(const NotifyEvent &ev)
+	{
+		if (m_subscribers.isEmpty())
+			return;
+
+		auto variable = NotifyRecordCache<EmulationVariableRowStore>::fetch(ev.objectId());
+
+		if (variable) {
+			auto emulationId = variable->emulationId;
+
+			if (m_subscribers.contains(emulationId)) {
+				m_variableOwners.insert(ev.objectId(), emulationId);
+
+				for (auto i : m_subscribers.values(emulationId))
+					i->appendVariable(ev);
+			}
+		}
+	}
+
+	void EmulationNotifyDispatcher::updateVariable(const NotifyEvent &ev)
+	{
+		NotifyRecordCache<EmulationVariableRowStore>::remove(ev.objectId());
+
+		for (auto i : recipients(m_variableOwners, ev.objectId()))
+			i->updateVariable(ev);
+	}
+
+	void EmulationNotifyDispatcher::removeVariable(const NotifyEvent &ev)
+	{
+		NotifyRecordCache<EmulationVariableRowStore>::remove(ev.objectId());
+
+		auto splitters = recipients(m_variableOwners, ev.objectId());
+
+		m_variableOwners.remove(ev.objectId());
+
+		for (auto i : splitters)
+			i->removeVariable(ev);
+	}
+
+	void EmulationNotifyDispatcher::appendFile(const NotifyEvent &ev)
+	{
+		if (m_subscribers.isEmpty())
+			return;
+
+		auto file = NotifyRecordCache<EmulationFileRowStore>::fetch(ev.objectId());
+
+		if (file) {
+			auto emulationId = file->emulationId;
+
+			if (m_subscribers.contains(emulationId)) {
+				m_fileOwners.insert(ev.objectId(), emulationId);
+
+				for (auto i : m_subscribers.values(emulationId))
+					i->appendFile(ev);
+			}
+		}
+	}
+
+	void EmulationNotifyDispatcher::updateFile(const NotifyEvent &ev)
+	{
+		NotifyRecordCache<EmulationFileRowStore>::remove(ev.objectId());
+
+		for (auto i : recipients(m_fileOwners, ev.objectId()))
+			i->updateFile(ev);
+	}
+
+	void EmulationNotifyDispatcher::removeFile(const NotifyEvent &ev)
+	{
+		NotifyRecordCache<EmulationFileRowStore>::remove(ev.objectId());
+
+		auto splitters = recipients(m_fileOwners, ev.objectId());
+
+		m_fileOwners.remove(ev.objectId());
+
+		for (auto i : splitters)
+			i->removeFile(ev);
+	}
+
+	QList<ViewDVFSplitter *> EmulationNotifyDispatcher::recipients(const QHash<long, long> &owners, const long id) const
+	{
+		auto it = owners.find(id);
+
+		if (it != owners.end())
+			return m_subscribers.values(it.value());
+
+		QList<ViewDVFSplitter *> result;
+
+		for (auto i : m_subscriptions.keys()) {
+			if (i->isLoading())
+				result << i;
+		}
+
+		return result;
+	}
+
+	// EditDVFSplitter
+	EditDVFSplitter::EditDVFSplitter(WidgetBase *parent)
+		: DVFSplitterBase(parent), m_fullSavePending(false)
+	{
+		init();
+	}
+
+	EditDVFSplitter::~EditDVFSplitter()
+	{
+		if (odb::transaction::has_current())
+			odb::transaction::current().callback_unregister(this);
+	}
+
+	void EditDVFSplitter::init()
+	{
+		//   
+		m_variablesWidget = new EditVariablesWidget(this);
+		addWidget(m_variablesWidget);
+
+		m_filesWidget = new EditFilesWidget(this);
+		addWidget(m_filesWidget);
+
+		if (isSettingsExist())
+			loadSettings();
+
+		connect(this, SIGNAL(splitterMoved(int, int)), SLOT(saveSettings()));
+	}
+
+	void EditDVFSplitter::clear()
+	{
+		DVFSplitterBase::clear();
+
+		m_variablesWidget->clear();
+		m_filesWidget->clear();
+	}
+
+	void EditDVFSplitter::variablesData(const emulation_dal::Emulation_variable_store &value)
+	{
+		m_variablesWidget->tableData(value);
+	}
+
+	void EditDVFSplitter::filesData(const emulation_dal::Emulation_file_store &value)
+	{
+		m_filesWidget->tableData(value);
+	}
+
+	EditVariablesTableModel *EditDVFSplitter::variablesModel() const
+	{
+		return m_variablesWidget->tableModel();
+	}
+
+	EditFilesTableModel *EditDVFSplitter::filesModel() const
+	{
+		return m_filesWidget->tableModel();
+	}
+
+	EditVariablesWidget *EditDVFSplitter::variablesWidget() const
+	{
+		return m_variablesWidget;
+	}
+
+	EditFilesWidget *EditDVFSplitter::filesWidget() const
+	{
+		return m_filesWidget;
+	}
+
+	void EditDVFSplitter::loadDBData()
+	{
+		clear();
+
+		m_fullSavePending = false;
+
+		DVFSplitterBase::loadDBData();
+
+		auto data = dbData();
 
 		if (data) {
 			variablesData(*data->emulation_variables());
 			filesData(*data->emulation_files());
-			m_filesWidget->useFileStore(data->emulation_use_file_store(), data->emulation_file_store_path());
+
+			m_filesWidget->useFileStore(data->emulation_use_file_store());
+			m_filesWidget->fileStorePath(data->emulation_file_store_path());
 		}
 
 	}
 
-	void ViewDVFSplitter::appendVariable(const NotifyEvent &ev)
+	void EditDVFSplitter::updateDBData()
 	{
-		auto variable = emulation_dal::Emulation_variable_store::query_one_by_id(ev.objectId());
+		DVFSplitterBase::updateDBData();
 
 		auto data = dbData();
 
-		if (variable && data) {
-			if (*variable->emulation() == *data)
-				m_variablesWidget->appendById(ev.objectId());
+		if (data) {
+			storeFilePayloads();
+
+			//       ,     
+			if (data->id() && odb::transaction::has_current() && !m_fullSavePending)
+				saveChanges(data);
+			else {
+				data->emulation_variables(*variablesModel());
+				data->emulation_files(*filesModel());
+
+				if (odb::transaction::has_current())
+					odb::transaction::current().callback_register(&EditDVFSplitter::changesSaved, this);
+				else
+					m_fullSavePending = true;
+			}
+
+			data->emulation_use_file_store(m_filesWidget->useFileStore());
+			data->emulation_file_store_path(m_filesWidget->fileStorePath());
+
 		}
+
 	}
 
-	void ViewDVFSplitter::updateVariable(const NotifyEvent &ev)
+	void EditDVFSplitter::saveChanges(const std::shared_ptr<emulation_dal::Emulation> &data)
 	{
-		auto data = dbData();
+		auto variables = variablesModel();
+		auto files = filesModel();
 
-		if (data) {
-				m_variablesWidget->updateById(ev.objectId());
+		if (!variables->hasChanges() && !files->hasChanges())
+			return;
+
+		odb::transaction &transaction = odb::transaction::current();
+		odb::database &db = transaction.database();
+
+		//   ,      
+		for (auto id : variables->removedIds())
+			db.erase<emulation_dal::Emulation_variable>(id);
+
+		for (auto id : files->removedIds())
+			db.erase<emulation_dal::Emulation_file>(id);
+
+		for (auto record : variables->updatedRecords())
+			db.update(record);
+
+		for (auto record : files->updatedRecords())
+			db.update(record);
+
+		for (auto record : variables->insertedRecords()) {
+			record->emulation(data);
+			db.persist(record);
+			variables->markPersisted(record);
 		}
 
+		for (auto record : files->insertedRecords()) {
+			record->emulation(data);
+			db.persist(record);
+			files->markPersisted(record);
+		}
+
+		transaction.callback_register(&EditDVFSplitter::changesSaved, this);
 	}
 
-	void ViewDVFSplitter::removeVariable(const NotifyEvent &ev)
+	void EditDVFSplitter::changesSaved(unsigned short event, void *key, unsigned long long)
 	{
-		auto data = dbData();
+		auto splitter = static_cast<EditDVFSplitter *>(key);
+		auto data = splitter->dbData();
+
+		if (event != odb::transaction::event_commit || !data)
+			return;
+
+		data->emulation_variables(*splitter->variablesModel());
+		data->emulation_files(*splitter->filesModel());
+
+		splitter->variablesModel()->acceptChanges();
+		splitter->filesModel()->acceptChanges();
+
+		splitter->m_fullSavePending = false;
+	}
+
+	void EditDVFSplitter::storeFilePayloads()
+	{
+		EmulationFileStore store(m_filesWidget->useFileStore() ? m_filesWidget->fileStorePath() : QString());
+
+		if (!store.isValid())
+			return;
+
+		auto files = filesModel();
+		bool changed = false;
+
+		for (int row = 0; row < static_cast<int>(files->size()); ++row) {
+			auto file = files->at(row);
+
+			if (!file || !file->ef_use_file_store() || file->ef_data().isEmpty() || EmulationFileStore::isReference(file->ef_data()))
+				continue;
+
+			auto content = EmulationFileCodec::data(*file);
+
+			if (content.isEmpty())
+				continue;
+
+			auto hash = store.put(content);
+
+			if (hash.isEmpty())
+				continue;
+
+			EmulationFileCodec::setData(*file, EmulationFileStore::reference(hash));
+			changed = true;
+
+			if (file->id())
+				files->markUpdated(row);
+		}
+
+		if (changed)
+			emit files->dataChanged(files->index(0, 0), files->index(files->rowCount() - 1, files->columnCount() - 1));
+	}
+
+	// RuntimeRequestsFilter
+	bool RuntimeRequestsFilter::isEmpty() const
+	{
+		return states.isEmpty() && !fromTime.isValid() && !toTime.isValid() && user.trimmed().isEmpty();
+	}
+
+	bool RuntimeRequestsFilter::isNewestFirst() const
+	{
+		return sortOrder == Qt::DescendingOrder;
+	}
+
+	bool RuntimeRequestsFilter::isDefault() const
+	{
+		return isEmpty() && sortField == SortById && isNewestFirst();
+	}
+
+	// RuntimeRequestsFilterForm
+	RuntimeRequestsFilterForm::RuntimeRequestsFilterForm(QWidget *parent)
+		: DialogFormBase(parent)
+	{
+		init();
+	}
+
+	void RuntimeRequestsFilterForm::init()
+	{
+		QGridLayout *mainLayout = new QGridLayout(this);
+
+		QLabel *statesLabel = new QLabel(tr("States"), this);
+		m_statesLine = new QLineEdit(this);
+		m_statesLine->setValidator(new QRegularExpressionValidator(QRegularExpression("^\\s*(\\d+\\s*(,\\s*\\d+\\s*)*)?$"), m_statesLine));
+		m_statesLine->setPlaceholderText(tr("Any state"));
+
+		mainLayout->addWidget(statesLabel, 0, 0);
+		mainLayout->addWidget(m_statesLine, 0, 1);
+
+		m_fromCheck = new CheckBox(tr("Created from"), this);
+		m_fromEdit = new QDateTimeEdit(QDateTime::currentDateTime().addDays(-7), this);
+		m_fromEdit->setCalendarPopup(true);
+
+		mainLayout->addWidget(m_fromCheck, 1, 0);
+		mainLayout->addWidget(m_fromEdit, 1, 1);
+
+		m_toCheck = new CheckBox(tr("Created to"), this);
+		m_toEdit = new QDateTimeEdit(QDateTime::currentDateTime(), this);
+		m_toEdit->setCalendarPopup(true);
+
+		mainLayout->addWidget(m_toCheck, 2, 0);
+		mainLayout->addWidget(m_toEdit, 2, 1);
+
+		QLabel *userLabel = new QLabel(tr("User"), this);
+		m_userLine = new QLineEdit(this);
+
+		mainLayout->addWidget(userLabel, 3, 0);
+		mainLayout->addWidget(m_userLine, 3, 1);
+
+		QLabel *sortLabel = new QLabel(tr("Sort by"), this);
+		m_sortFieldCombo = new QComboBox(this);
+		m_sortFieldCombo->addItem(tr("Request number"), RuntimeRequestsFilter::SortById);
+		m_sortFieldCombo->addItem(tr("Creation time"), RuntimeRequestsFilter::SortByCreationTime);
+
+		m_sortOrderCombo = new QComboBox(this);
+		m_sortOrderCombo->addItem(tr("Newest first"), Qt::DescendingOrder);
+		m_sortOrderCombo->addItem(tr("Oldest first"), Qt::AscendingOrder);
+
+		mainLayout->addWidget(sortLabel, 4, 0);
+		mainLayout->addWidget(m_sortFieldCombo, 4, 1);
+		mainLayout->addWidget(m_sortOrderCombo, 5, 1);
+
+		connect(m_fromCheck, SIGNAL(toggled(bool)), SLOT(updateAccesibility()));
+		connect(m_toCheck, SIGNAL(toggled(bool)), SLOT(updateAccesibility()));
+
+		updateAccesibility();
+	}
+
+	RuntimeRequestsFilter RuntimeRequestsFilterForm::filter() const
+	{
+		RuntimeRequestsFilter result;
+
+		for (auto state : m_statesLine->text().split(',', Qt::SkipEmptyParts)) {
+			bool ok;
+			int value = state.trimmed().toInt(&ok);
+
+			if (ok && !result.states.contains(value))
+				result.states << value;
+		}
+
+		if (m_fromCheck->isChecked())
+			result.fromTime = m_fromEdit->dateTime();
+
+		if (m_toCheck->isChecked())
+			result.toTime = m_toEdit->dateTime();
+
+		result.user = m_userLine->text().trimmed();
+
+		result.sortField = static_cast<RuntimeRequestsFilter::SortField>(m_sortFieldCombo->currentData().toInt());
+		result.sortOrder = static_cast<Qt::SortOrder>(m_sortOrderCombo->currentData().toInt());
+
+		return result;
+	}
+
+	void RuntimeRequestsFilterForm::filter(const RuntimeRequestsFilter &value)
+	{
+		QStringList states;
+
+		for (auto state : value.states)
+			states << QString::number(state);
+
+		m_statesLine->setText(states.join(", "));
+
+		m_fromCheck->setChecked(value.fromTime.isValid());
+
+		if (value.fromTime.isValid())
+			m_fromEdit->setDateTime(value.fromTime);
+
+		m_toCheck->setChecked(value.toTime.isValid());
+
+		if (value.toTime.isValid())
+			m_toEdit->setDateTime(value.toTime);
+
+		m_userLine->setText(value.user);
+
+		m_sortFieldCombo->setCurrentIndex(m_sortFieldCombo->findData(value.sortField));
+		m_sortOrderCombo->setCurrentIndex(m_sortOrderCombo->findData(value.sortOrder));
+
+		updateAccesibility();
+	}
+
+	void RuntimeRequestsFilterForm::updateAccesibility()
+	{
+		m_fromEdit->setEnabled(m_fromCheck->isChecked());
+		m_toEdit->setEnabled(m_toCheck->isChecked());
+	}
+
+	// RuntimeRequestsFilterDialog
+	RuntimeRequestsFilterDialog::RuntimeRequestsFilterDialog(const RuntimeRequestsFilter &value, QWidget *parent)
+		: DialogBase(parent)
+	{
+		init();
+
+		RuntimeRequestsFilterForm *filterForm = new RuntimeRequestsFilterForm(this);
+		filterForm->filter(value);
+
+		DialogBase::form(filterForm);
+	}
+
+	void RuntimeRequestsFilterDialog::init()
+	{
+		setWindowTitle(tr("Find Runtime Requests"));
+	}
+
+	RuntimeRequestsFilter RuntimeRequestsFilterDialog::filter() const
+	{
+		RuntimeRequestsFilterForm *dlgForm = form();
+
+		if (dlgForm)
+			return dlgForm->filter();
+		else
+			return RuntimeRequestsFilter();
+	}
+
+	RuntimeRequestsFilterForm *RuntimeRequestsFilterDialog::form() const
+	{
+		return dynamic_cast<RuntimeRequestsFilterForm *>(DialogBase::form());
+	}
+
+	// EmulationRuntimeRequestsModel
+	EmulationRuntimeRequestsModel::EmulationRuntimeRequestsModel(WidgetBase *parent)
+		: RuntimeRequestsModelBase(DoNotAutoLoad, parent), ParentWidget(parent), m_lastId(0), m_hasMore(false), m_snapshotId(0)
+	{
+		init();
+
+		loadDBData();
+	}
+
+	void EmulationRuntimeRequestsModel::init()
+	{
+		auto loader = EmulationSnapshotLoader::attach(m_parentContainerWidget);
+
+		if (loader)
+			connect(loader, SIGNAL(loaded(const std::shared_ptr<EmulationSnapshot> &)), SLOT(snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &)));
+
+		m_rowIndex = new DBModelRowIndex<EmulationRuntimeRequestsModel>(this);
+
+		m_coalescer = new NotifyEventCoalescer(this);
+
+		connect(m_coalescer, SIGNAL(batchReady(const NotifyEventBatch &)), SLOT(applyBatch(const NotifyEventBatch &)));
+
+		createUpdateConnections();
+	}
+
+	void EmulationRuntimeRequestsModel::loadDBData()
+	{
+		m_coalescer->clear();
+
+		resetPageBounds();
+		m_snapshotId = 0;
+
+		auto data = emulation();
+		auto loader = EmulationSnapshotLoader::of(this);
+
+		if (data && loader && m_filter.isDefault()) {
+			RuntimeRequestsModelBase::clearDataVector();
+
+			m_snapshotId = data->id();
+
+			loader->load(data->id(), EmulationSnapshot::RuntimeRequests);
+		}
+		else if (data) {
+			auto page = queryPage(data->id());
+
+			setDataVector(*page);
+			setPageBounds(*page);
+		}
+	}
+
+	void EmulationRuntimeRequestsModel::snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot)
+	{
+		if (!m_snapshotId || snapshot->emulationId != m_snapshotId)
+			return;
+
+		if (snapshot->failed(EmulationSnapshot::RuntimeRequests)) {
+			m_snapshotId = 0;
+
+			try {
+				auto page = queryPage(snapshot->emulationId);
+
+				NotifyBatchApplier<emulation_dal::Emulation_runtime_request_store>::appendRecords(this, *page);
+				setPageBounds(*page);
+			}
+			catch (const odb::exception &) {
+			}
 
-		if (data) {
-			m_variablesWidget->removeById(ev.objectId());
+			return;
 		}
 
-	}
+		if (!snapshot->parts.testFlag(EmulationSnapshot::RuntimeRequests))
+			return;
 
-	void ViewDVFSplitter::appendFile(const NotifyEvent &ev)
-	{
-		auto file = emulation_dal::Emulation_file_store::query_one_by_id(ev.objectId());
+		m_snapshotId = 0;
 
-		auto data = dbData();
+		auto page = std::move(snapshot->runtimeRequests);
 
-		if (file && data) {
-			if (*file->emulation() == *data)
-				m_filesWidget->appendById(ev.objectId());
-		}
+		if (!page)
+			return;
 
+		setPageBounds(*page);
+
+		NotifyBatchApplier<emulation_dal::Emulation_runtime_request_store>::appendRecords(this, std::move(*page));
 	}
 
-	void ViewDVFSplitter::updateFile(const NotifyEvent &ev)
+	void EmulationRuntimeRequestsModel::clearDataVector()
 	{
-		auto data = dbData();
-
-		if (& data) {
-			m_filesWidget->updateById(ev.objectId());
-		}
+		resetPageBounds();
+		m_snapshotId = 0;
 
+		RuntimeRequestsModelBase::clearDataVector();
 	}
-	
-	void ViewDVFSplitter::removeFile(const NotifyEvent &ev)
+
+	const RuntimeRequestsFilter &EmulationRuntimeRequestsModel::filter() const
 	{
-		auto data = dbData();
+		return m_filter;
+	}
 
-		if (data) {
-			m_filesWidget->removeById(ev.objectId());
-		}
+	void EmulationRuntimeRequestsModel::setFilter(const RuntimeRequestsFilter &value)
+	{
+		m_filter = value;
 
+		loadDBData();
 	}
 
-	// EditDVFSplitter
-	EditDVFSplitter::EditDVFSplitter(WidgetBase *parent)
-		: DVFSplitterBase(parent)
+	bool EmulationRuntimeRequestsModel::canFetchMore(const QModelIndex &parent) const
 	{
-		init();
+		return !parent.isValid() && m_hasMore;
 	}
 
-	void EditDVFSplitter::init()
+	void EmulationRuntimeRequestsModel::fetchMore(const QModelIndex &parent)
 	{
-		//   
-		m_variablesWidget = new EditVariablesWidget(this);
-		addWidget(m_variablesWidget);
+		auto data = emulation();
 
-		m_filesWidget = new EditFilesWidget(this);
-		addWidget(m_filesWidget);
+		if (parent.isValid() || !m_hasMore || !data)
+			return;
 
-		if (isSettingsExist())
-			loadSettings();
+		auto page = queryPage(data->id());
 
-		connect(this, SIGNAL(splitterMoved(int, int)), SLOT(saveSettings()));
+		NotifyBatchApplier<emulation_dal::Emulation_runtime_request_store>::appendRecords(this, *page);
+		setPageBounds(*page);
 	}
 
-	void EditDVFSplitter::clear()
+	odb::query<emulation_dal::Emulation_runtime_request> EmulationRuntimeRequestsModel::filterQuery(const long emulationId, const RuntimeRequestsFilter &filter)
 	{
-		DVFSplitterBase::clear();
+		typedef odb::query<emulation_dal::Emulation_runtime_request> query;
 
-		m_variablesWidget->clear();
-		m_filesWidget->clear();
-	}
+		query q(query::emulation == query::_val(emulationId));
 
-	void EditDVFSplitter::variablesData(const emulation_dal::Emulation_variable_store &value)
-	{
-		m_variablesWidget->tableData(value);
-	}
+		if (!filter.states.isEmpty())
+			q = q && query::err_status.in_range(filter.states.begin(), filter.states.end());
 
-	void EditDVFSplitter::filesData(const emulation_dal::Emulation_file_store &value)
-	{
-		m_filesWidget->tableData(value);
-	}
+		if (filter.fromTime.isValid())
+			q = q && query::err_creation_time >= query::_val(filter.fromTime);
 
-	EditVariablesTableModel *EditDVFSplitter::variablesModel() const
-	{
-		return m_variablesWidget->tableModel();
-	}
+		if (filter.toTime.isValid())
+			q = q && query::err_creation_time <= query::_val(filter.toTime);
 
-	EditFilesTableModel *EditDVFSplitter::filesModel() const
-	{
-		return m_filesWidget->tableModel();
+		if (!filter.user.trimmed().isEmpty()) {
+			auto user = filter.user.trimmed().replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+
+			q = q && query::err_user.like(query::_val(QString("%%1%").arg(user)), "\\");
+		}
+
+		return q;
 	}
 
-	EditVariablesWidget *EditDVFSplitter::variablesWidget() const
+	odb::query<emulation_dal::Emulation_runtime_request> EmulationRuntimeRequestsModel::pageQuery(const long emulationId, const RuntimeRequestsFilter &filter,
+		const long lastId, const QDateTime &lastTime)
 	{
-		return m_variablesWidget;
+		typedef odb::query<emulation_dal::Emulation_runtime_request> query;
+
+		query q(filterQuery(emulationId, filter));
+
+		const bool descending = filter.sortOrder == Qt::DescendingOrder;
+
+		//    :       OFFSET     
+		if (lastId > 0) {
+			if (filter.sortField == RuntimeRequestsFilter::SortByCreationTime) {
+				if (descending)
+					q = q && (query::err_creation_time < query::_val(lastTime) ||
+						(query::err_creation_time == query::_val(lastTime) && query::id < query::_val(lastId)));
+				else
+					q = q && (query::err_creation_time > query::_val(lastTime) ||
+						(query::err_creation_time == query::_val(lastTime) && query::id > query::_val(lastId)));
+			}
+			else if (descending)
+				q = q && query::id < query::_val(lastId);
+			else
+				q = q && query::id > query::_val(lastId);
+		}
+
+		const char *direction = descending ? "DESC" : "ASC";
+
+		if (filter.sortField == RuntimeRequestsFilter::SortByCreationTime)
+			q = q + "ORDER BY" + query::err_creation_time + direction + "," + query::id + direction;
+		else
+			q = q + "ORDER BY" + query::id + direction;
+
+		q = q + "LIMIT" + query::_val(PageSize);
+
+		return q;
 	}
 
-	EditFilesWidget *EditDVFSplitter::filesWidget() const
+	std::shared_ptr<emulation_dal::Emulation_runtime_request_store> EmulationRuntimeRequestsModel::queryPage(const long emulationId) const
 	{
-		return m_filesWidget;
+		return emulation_dal::Emulation_runtime_request_store::query(pageQuery(emulationId, m_filter, m_lastId, m_lastTime));
 	}
 
-	void EditDVFSplitter::loadDBData()
+	bool EmulationRuntimeRequestsModel::matchesFilter(const long id) const
 	{
-		clear();
+		typedef odb::query<emulation_dal::Emulation_runtime_request> query;
 
-		DVFSplitterBase::loadDBData();
+		auto data = emulation();
 
-		auto data = dbData();
+		if (!data)
+			return false;
 
-		if (data) {
-			variablesData(*data->emulation_variables());
-			filesData(*data->emulation_files());
+		auto records = emulation_dal::Emulation_runtime_request_store::query(filterQuery(data->id(), m_filter) && query::id == query::_val(id));
 
-			m_filesWidget->useFileStore(data->emulation_use_file_store());
-			m_filesWidget->fileStorePath(data->emulation_file_store_path());
+		return records && !records->empty();
+	}
+
+	void EmulationRuntimeRequestsModel::setPageBounds(const emulation_dal::Emulation_runtime_request_store &page)
+	{
+		if (!page.empty() && page.back()) {
+			m_lastId = page.back()->id();
+			m_lastTime = page.back()->err_creation_time();
 		}
 
+		m_hasMore = page.size() >= static_cast<size_t>(PageSize);
 	}
 
-	void EditDVFSplitter::updateDBData()
+	void EmulationRuntimeRequestsModel::resetPageBounds()
 	{
-		DVFSplitterBase::updateDBData();
-
-		auto data = dbData();
+		m_lastId = 0;
+		m_lastTime = QDateTime();
+		m_hasMore = false;
+	}
 
-		if (data) {
-			data->emulation_variables(*variablesModel());
-			data->emulation_files(*filesModel());
+	NotifyEventCoalescer *EmulationRuntimeRequestsModel::coalescer() const
+	{
+		return m_coalescer;
+	}
 
-			data->emulation_use_file_store(m_filesWidget->useFileStore());
-			data->emulation_file_store_path(m_filesWidget->fileStorePath());
+	void EmulationRuntimeRequestsModel::applyBatch(const NotifyEventBatch &batch)
+	{
+		if (m_filter.isNewestFirst() || !m_hasMore)
+			NotifyBatchApplier<emulation_dal::Emulation_runtime_request_store>::apply(this, batch, m_filter.isNewestFirst());
+		else {
+			NotifyEventBatch loadedBatch = batch;
+			loadedBatch.added.clear();
 
+			NotifyBatchApplier<emulation_dal::Emulation_runtime_request_store>::apply(this, loadedBatch);
 		}
-
 	}
 
-	// EmulationRuntimeRequestsModel
-	EmulationRuntimeRequestsModel::EmulationRuntimeRequestsModel(WidgetBase *parent)
-		: RuntimeRequestsModelBase(DoNotAutoLoad, parent), ParentWidget(parent)
+	int EmulationRuntimeRequestsModel::rowById(const long id) const
 	{
-		init();
-
-		loadDBData();
+		return m_rowIndex->row(id);
 	}
 
-	void EmulationRuntimeRequestsModel::init()
+	bool EmulationRuntimeRequestsModel::containsId(const long id) const
 	{
-		createUpdateConnections();
+		return m_rowIndex->contains(id);
 	}
 
-	void EmulationRuntimeRequestsModel::loadDBData()
+	bool EmulationRuntimeRequestsModel::updateById(const long id)
 	{
-		auto data = emulation();
+		return containsId(id) && RuntimeRequestsModelBase::updateById(id);
+	}
 
-		if (data)
-			setDataVector(*data->emulation_runtime_requests());
+	bool EmulationRuntimeRequestsModel::removeById(const long id)
+	{
+		return containsId(id) && RuntimeRequestsModelBase::removeById(id);
 	}
 	
 	const std::shared_ptr<emulation_dal::Emulation> EmulationRuntimeRequestsModel::emulation() const
@@ -2195,22 +5964,35 @@ namespace Emulation
 	
 	void EmulationRuntimeRequestsModel::append(const NotifyEvent &ev)
 	{
-		std::shared_ptr<emulation_dal::Emulation_runtime_request> newRecord = Emulation_runtime_request_store::query_one_by_id(ev.objectId());
+		std::shared_ptr<emulation_dal::Emulation_runtime_request> newRecord = NotifyRecordCache<emulation_dal::Emulation_runtime_request_store>::fetch(ev.objectId());
 
 		auto data = emulation();
 
-		if (newRecord && newRecord->emulation() && data && newRecord->emulation_id() == data->id())
-			appendById(ev.objectId());
+		if (newRecord && newRecord->emulation() && data && newRecord->emulation_id() == data->id() &&
+			(m_filter.isEmpty() || matchesFilter(ev.objectId())))
+			m_coalescer->append(ev.objectId());
 	}
 
 	void EmulationRuntimeRequestsModel::update(const NotifyEvent &ev)
 	{
-		updateById(ev.objectId());
+		NotifyRecordCache<emulation_dal::Emulation_runtime_request_store>::remove(ev.objectId());
+
+		if (containsId(ev.objectId())) {
+			if (m_filter.isEmpty() || matchesFilter(ev.objectId()))
+				m_coalescer->update(ev.objectId());
+			else
+				m_coalescer->remove(ev.objectId());
+		}
+		else if (!m_filter.isEmpty())
+			append(ev);
 	}
 
 	void EmulationRuntimeRequestsModel::remove(const NotifyEvent &ev)
 	{
-		removeById(ev.objectId());
+		NotifyRecordCache<emulation_dal::Emulation_runtime_request_store>::remove(ev.objectId());
+
+		if (containsId(ev.objectId()))
+			m_coalescer->remove(ev.objectId());
 	}
 
 	void EmulationRuntimeRequestsModel::createUpdateConnections()
@@ -2308,8 +6090,10 @@ namespace Emulation
 
 	void RuntimeRequestsWidget::clear()
 	{
-		if (model())
+		if (model()) {
+			model()->coalescer()->clear();
 			model()->clearDataVector();
+		}
 	}
 
 
@@ -2359,6 +6143,19 @@ namespace Emulation
 
 	}
 
+	void RuntimeRequestsWidget::onFindAction()
+	{
+		if (!model())
+			return;
+
+		RuntimeRequestsFilterDialog *dialog = new RuntimeRequestsFilterDialog(model()->filter(), this);
+
+		if (dialog->exec() == QDialog::Accepted)
+			model()->setFilter(dialog->filter());
+
+		dialog->deleteLater();
+	}
+
 	// BasicsWidgetBase
 	BasicsWidgetBase::BasicsWidgetBase(WidgetBase *containerWidget)
 		: QWidget(containerWidget), ParentWidget(containerWidget)
@@ -2380,7 +6177,9 @@ namespace Emulation
 		m_dateLayout->addWidget(new QLabel(tr("Editing date:"), this), 0, 2);
 		m_dateLayout->addWidget(m_editingDateTimeValueLabel = new QLabel("-", this), 0, 3);
 
-		connect(emulation_dal::DB::notifier()->Emulation_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateDates(const NotifyEvent &)));
+		EmulationSession::attach(m_parentContainerWidget);
+
+		connect(EmulationNotifyDispatcher::instance(), SIGNAL(emulationUpdated(const NotifyEvent &)), SLOT(updateDates(const NotifyEvent &)));
 	}
 
 	void BasicsWidgetBase::loadDBData()
@@ -2451,20 +6250,214 @@ namespace Emulation
 	void BasicsWidgetBase::updateDates(const NotifyEvent &ev)
 	{
 		auto data = dbData();
-		if (data) {
-			auto emulation = emulation_dal::Emulation_store::query_one_by_id(ev.objectId());
 
-			if (emulation && *data == *emulation) {
-				loadDBData();
-			}
+		if (data && data->id() == ev.objectId() && EmulationNotifyDispatcher::instance()->emulation(ev))
+			loadDBData();
+
+	}
+
+	// TopologyHostsCounter
+	TopologyHostsCounter::TopologyHostsCounter(QObject *parent)
+		: QObject(parent)
+	{
+		init();
+	}
+
+	TopologyHostsCounter *TopologyHostsCounter::instance()
+	{
+		static TopologyHostsCounter *counter = new TopologyHostsCounter(qApp);
+
+		return counter;
+	}
+
+	void TopologyHostsCounter::init()
+	{
+		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(appendHost(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(updated(const NotifyEvent &)), SLOT(updateHost(const NotifyEvent &)));
+		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(removeHost(const NotifyEvent &)));
+	}
+
+	void TopologyHostsCounter::load(const std::shared_ptr<emulation_dal::Emulation_topology_canvas> &canvas)
+	{
+		if (!canvas || isLoaded(canvas->id()))
+			return;
+
+		auto hosts = canvas->emulation_topology_hosts();
+
+		load(canvas, hosts ? *hosts : emulation_dal::Emulation_topology_host_store());
+	}
+
+	void TopologyHostsCounter::load(const std::shared_ptr<emulation_dal::Emulation_topology_canvas> &canvas, const emulation_dal::Emulation_topology_host_store &hosts)
+	{
+		if (!canvas)
+			return;
+
+		reset(canvas->id());
+
+		m_counts.insert(canvas->id(), QHash<long, int>());
+
+		for (auto i : hosts)
+			insertHost(canvas->id(), i);
+
+		emit countChanged(canvas->id());
+	}
+
+	bool TopologyHostsCounter::isLoaded(const long canvasId) const
+	{
+		return m_counts.contains(canvasId);
+	}
+
+	QSet<long> TopologyHostsCounter::loadedCanvases() const
+	{
+		auto keys = m_counts.keys();
+
+		return QSet<long>(keys.begin(), keys.end());
+	}
+
+	void TopologyHostsCounter::attach(const long canvasId)
+	{
+		if (canvasId)
+			++m_viewers[canvasId];
+	}
+
+	void TopologyHostsCounter::detach(const long canvasId)
+	{
+		auto it = m_viewers.find(canvasId);
+
+		if (it == m_viewers.end())
+			return;
+
+		if (--it.value() <= 0) {
+			m_viewers.erase(it);
+			reset(canvasId);
+		}
+	}
+
+	void TopologyHostsCounter::reset(const long canvasId)
+	{
+		m_counts.remove(canvasId);
+
+		for (auto it = m_hosts.begin(); it != m_hosts.end();) {
+			if (it.value().first == canvasId)
+				it = m_hosts.erase(it);
+			else
+				++it;
+		}
+	}
+
+	int TopologyHostsCounter::count(const long canvasId, const long hostTypeId) const
+	{
+		return m_counts.value(canvasId).value(hostTypeId);
+	}
+
+	int TopologyHostsCounter::virtualHostsCount(const long canvasId) const
+	{
+		int result = 0;
+
+		auto counts = m_counts.value(canvasId);
+
+		for (auto it = counts.begin(); it != counts.end(); ++it) {
+			if (m_virtualHostTypes.value(it.key()))
+				result += it.value();
+		}
+
+		return result;
+	}
+
+	void TopologyHostsCounter::insertHost(const long canvasId, const std::shared_ptr<emulation_dal::Emulation_topology_host> &host)
+	{
+		if (!host || m_hosts.contains(host->id()))
+			return;
+
+		auto hostTypeId = host->eht_id();
+
+		isVirtualHostType(hostTypeId, host);
+
+		m_hosts.insert(host->id(), qMakePair(canvasId, hostTypeId));
+		m_counts[canvasId][hostTypeId]++;
+	}
+
+	bool TopologyHostsCounter::isVirtualHostType(const long hostTypeId, const std::shared_ptr<emulation_dal::Emulation_topology_host> &host)
+	{
+		auto it = m_virtualHostTypes.find(hostTypeId);
+
+		if (it != m_virtualHostTypes.end())
+			return it.value();
+
+		auto hostType = host->eht();
+		bool result = hostType && hostType->eht_code() == Topology2D::VirtualHostObject::typeCode();
+
+		m_virtualHostTypes.insert(hostTypeId, result);
+
+		return result;
+	}
+
+	void TopologyHostsCounter::appendHost(const NotifyEvent &ev)
+	{
+		if (m_counts.isEmpty())
+			return;
+
+		auto host = QueryByIdCache<emulation_dal::Emulation_topology_host_store>::fetch(ev.objectId());
+
+		if (host && isLoaded(host->etc_id())) {
+			insertHost(host->etc_id(), host);
+
+			emit countChanged(host->etc_id());
+		}
+
+	}
+
+	void TopologyHostsCounter::updateHost(const NotifyEvent &ev)
+	{
+		if (m_counts.isEmpty())
+			return;
+
+		auto host = QueryByIdCache<emulation_dal::Emulation_topology_host_store>::fetch(ev.objectId());
 
+		auto previousCanvasId = eraseHost(ev.objectId());
+
+		if (host && isLoaded(host->etc_id())) {
+			insertHost(host->etc_id(), host);
+
+			emit countChanged(host->etc_id());
 		}
 
+		if (previousCanvasId && (!host || previousCanvasId != host->etc_id()))
+			emit countChanged(previousCanvasId);
+	}
+
+	void TopologyHostsCounter::removeHost(const NotifyEvent &ev)
+	{
+		auto canvasId = eraseHost(ev.objectId());
+
+		if (canvasId)
+			emit countChanged(canvasId);
+
+	}
+
+	long TopologyHostsCounter::eraseHost(const long hostId)
+	{
+		auto it = m_hosts.find(hostId);
+
+		if (it == m_hosts.end())
+			return 0;
+
+		auto canvasId = it.value().first;
+		auto hostTypeId = it.value().second;
+
+		m_hosts.erase(it);
+
+		auto &counter = m_counts[canvasId][hostTypeId];
+
+		if (counter > 0)
+			--counter;
+
+		return canvasId;
 	}
 
 	// ViewBasicsWidget
 	ViewBasicsWidget::ViewBasicsWidget(ViewWidget *viewWidget)
-		: BasicsWidgetBase(viewWidget)
+		: BasicsWidgetBase(viewWidget), m_canvasId(0)
 	{
 		//   
 		init();
@@ -2472,6 +6465,23 @@ namespace Emulation
 		loadDBData();
 	}
 
+	ViewBasicsWidget::~ViewBasicsWidget()
+	{
+		TopologyHostsCounter::instance()->detach(m_canvasId);
+	}
+
+	void ViewBasicsWidget::canvasId(const long value)
+	{
+		if (value == m_canvasId)
+			return;
+
+		TopologyHostsCounter::instance()->detach(m_canvasId);
+
+		m_canvasId = value;
+
+		TopologyHostsCounter::instance()->attach(m_canvasId);
+	}
+
 	void ViewBasicsWidget::init()
 	{
 		m_dvfWidget = new ViewDVFSplitter(m_parentContainerWidget);
@@ -2491,8 +6501,12 @@ namespace Emulation
 
 		m_mainLayout->addLayout(m_dateLayout);
 
-		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(added(const NotifyEvent &)), SLOT(updateHostsCount()));
-		connect(emulation_dal::DB::notifier()->Emulation_topology_host_notify(), SIGNAL(removed(const NotifyEvent &)), SLOT(updateHostsCount()));
+		connect(TopologyHostsCounter::instance(), SIGNAL(countChanged(const long)), SLOT(updateHostsCount(const long)));
+
+		auto loader = EmulationSnapshotLoader::attach(m_parentContainerWidget);
+
+		if (loader)
+			connect(loader, SIGNAL(loaded(const std::shared_ptr<EmulationSnapshot> &)), SLOT(snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &)));
 
 	}
 
@@ -2523,32 +6537,67 @@ namespace Emulation
 
 	void ViewBasicsWidget::updateHostsCount()
 	{
+		EmulationSession::Scope scope(this);
+
 		hostsCount("-");
 
+		canvasId(0);
+
 		auto data = dbData();
 
 		if (data) {
 			auto canvas = data->etc();
 
 			if (canvas) {
-				auto hosts = canvas->emulation_topology_hosts();
+				canvasId(canvas->id());
 
-				if (hosts) {
-					int counter = 0;
+				TopologyHostsCounter::instance()->load(canvas);
 
-					for (auto i : *hosts) {
-						if (i->eht() && i->eht()->eht_code() == Topology2D::VirtualHostObject::typeCode())
-							counter++;
-					}
+				hostsCount(TopologyHostsCounter::instance()->virtualHostsCount(m_canvasId));
+			}
+
+		}
 
-					hostsCount(counter);
+	}
 
-				}
+	void ViewBasicsWidget::snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot)
+	{
+		auto data = dbData();
+
+		if (!data || snapshot->emulationId != data->id())
+			return;
 
+		if (snapshot->failed(EmulationSnapshot::TopologyHosts)) {
+			try {
+				updateHostsCount();
 			}
+			catch (const odb::exception &) {
+			}
+
+			return;
+		}
+
+		if (!snapshot->parts.testFlag(EmulationSnapshot::TopologyHosts))
+			return;
+
+		auto hosts = std::move(snapshot->topologyHosts);
+
+		if (snapshot->canvas) {
+			canvasId(snapshot->canvas->id());
 
+			if (hosts)
+				TopologyHostsCounter::instance()->load(snapshot->canvas, *hosts);
+			else
+				TopologyHostsCounter::instance()->load(snapshot->canvas);
+
+			hostsCount(TopologyHostsCounter::instance()->virtualHostsCount(m_canvasId));
 		}
+	}
 
+	void ViewBasicsWidget::updateHostsCount(const long canvasId)
+	{
+		if (m_canvasId && canvasId == m_canvasId)
+			hostsCount(TopologyHostsCounter::instance()->virtualHostsCount(m_canvasId));
 	}
 
 	void ViewBasicsWidget::loadDBData()
@@ -2563,7 +6612,16 @@ namespace Emulation
 
 			m_dvfWidget->loadDBData();
 
-			updateHostsCount();
+			auto loader = EmulationSnapshotLoader::attach(m_parentContainerWidget);
+
+			if (loader) {
+				hostsCount("-");
+				canvasId(0);
+
+				loader->load(data->id(), EmulationSnapshot::TopologyHosts);
+			}
+			else
+				updateHostsCount();
 
 		}
 
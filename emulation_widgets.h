@@ -9,6 +9,10 @@
 
 #include "common/widgets.h"
 #include "emulation_baseclasses.h"
+#include "emulation_display_rows.h"
+#include "emulation_file_store.h"
+
+#include <QFutureWatcher>
 
 #include "dictionary_models.h"
 #include "dictionary_widgets.h"
@@ -283,20 +287,46 @@ namespace Emulation
 		/// Функция возвращает данные, хранящиеся в таблице БД Emulation_variable
 		const std::shared_ptr<emulation_dal::Emulation_file> &dbData() const;
 
+		/**
+		*
+		* \brief Функция служит для установки пути к файловому хранилищу сценария
+		*
+		* Пустой путь означает, что содержимое файла хранится в БД.
+		*
+		* \param value - путь к файловому хранилищу
+		*
+		*/
+		void fileStorePath(const QString &value);
+
 	public slots:
 		/// Функция служит для обновления данных, содержащихся в таблице БД Emulation_variable		
 		void updateDBData();
 
+	private slots:
+		/// Функция загружает содержимое файла сценария с диска
+		void loadContent();
+
+		/// Функция сохраняет содержимое файла сценария на диск
+		void saveContent();
+
 	protected:
 		/// Функция инициализации базовых параметров формы
 		void init();
 
+		/// Функция обновляет сведения о содержимом файла
+		void updateContentLine();
+
 		std::shared_ptr<emulation_dal::Emulation_file> m_dbData; ///< Данные из таблицы БД Emulation_variable
 
+		QString m_fileStorePath; ///< Путь к файловому хранилищу сценария
+		QByteArray m_content; ///< Загруженное содержимое или ссылка на объект файлового хранилища
+		bool m_contentChanged = false; ///< Признак загрузки нового содержимого
+
 		QLineEdit *m_fileNameLine; ///< Виджет для редактирования имени переменной
 		FileTypesListComboBox *m_fileTypeCombo; ///< Выпадающий список для выбора типа переменной
 		CheckBox *m_useStoreCheck; ///< Виджет для задания флага произвольности длины
 		PlainTextEdit *m_descriptionEdit; ///< Виджет для редактирования описания переменной
+		QLineEdit *m_contentLine; ///< Виджет для отображения сведений о содержимом файла
 	};
 
 	/**
@@ -389,10 +419,33 @@ namespace Emulation
 
 	/**
 	*
-	* \brief Модель для просмотра списка переменных сценария.
+	* \brief Пакет уведомлений БД, накопленных за один такт цикла обработки событий или заданный интервал времени
+	*
+	*/
+	struct NotifyEventBatch
+	{
+		QList<long> added; ///< Идентификаторы добавленных записей в порядке поступления уведомлений
+		QSet<long> updated; ///< Идентификаторы измененных записей
+		QSet<long> removed; ///< Идентификаторы удаленных записей
+
+		int eventsCount = 0; ///< Количество уведомлений, объединенных в пакет
+
+		/// Функция возвращает признак отсутствия изменений в пакете
+		bool isEmpty() const;
+
+		/// Функция возвращает количество операций над моделью, оставшихся после объединения уведомлений
+		int operationsCount() const;
+	};
+
+	/**
+	*
+	* \brief Класс, служащий для объединения уведомлений БД в пакеты
+	*
+	* Уведомления о добавлении, изменении и удалении записей накапливаются и передаются модели одним пакетом.
+	* Повторные изменения одной записи объединяются, добавление с последующим удалением взаимно исключаются.
 	*
 	*/
-	class ViewVariablesTableModel : public DBTableModel<emulation_dal::Emulation_variable>
+	class NotifyEventCoalescer : public QObject
 	{
 		Q_OBJECT
 
@@ -403,43 +456,73 @@ namespace Emulation
 		*
 		* \param parent - указатель на родительский объект
 		*
-		*/		
-		ViewVariablesTableModel(QObject *parent = nullptr);
-		
+		*/
+		explicit NotifyEventCoalescer(QObject *parent = nullptr);
+
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция служит для установки интервала накопления уведомлений
 		*
-		* \param value - список переменных для отображения
-		* \param parent - указатель на родительский объект
+		* \param msec - интервал в миллисекундах; 0 - уведомления накапливаются в течение одного такта цикла обработки событий
 		*
 		*/
-		ViewVariablesTableModel(const emulation_dal::Emulation_variable_store &value, QObject *parent = nullptr);
+		void setInterval(const int msec);
 
-		/// Функция возвращает заголовки столбцов модели
-		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+		/// Функция возвращает интервал накопления уведомлений
+		int interval() const;
 
-		/// Функция возвращает данные, содержащиеся в таблице
-		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+		/// Функция возвращает общее количество полученных уведомлений
+		int eventsCount() const;
 
-		/// Функция возвращает количество строк в модели
-		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+		/// Функция возвращает количество уведомлений, поглощенных при объединении
+		int mergedCount() const;
 
-		/// Функция возвращает количество столбцов в модели
-		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	signals:
+		/// Сигнал испускается при готовности очередного пакета уведомлений
+		void batchReady(const NotifyEventBatch &batch);
 
-	private slots:
-		DB_EVENT_FUNCTIONS(emulation_dal::DB::notifier()->Emulation_variable_notify())
+	public slots:
+		/// Слот служит для регистрации уведомления о добавлении записи с заданным индексом
+		void append(const long id);
 
-	protected:
-		/// Функция инициализации базовых параметров модели
+		/// Слот служит для регистрации уведомления об изменении записи с заданным индексом
+		void update(const long id);
+
+		/// Слот служит для регистрации уведомления об удалении записи с заданным индексом
+		void remove(const long id);
+
+		/// Слот служит для немедленной передачи накопленных уведомлений
+		void flush();
+
+		/// Слот служит для отбрасывания накопленных уведомлений
+		void clear();
+
+	private:
+		/// Функция инициализации базовых параметров объекта
 		void init();
 
-		READONLY_FLAGS_FUNCTION
+		/// Функция запускает таймер передачи пакета, если он еще не запущен
+		void schedule();
+
+		QTimer *m_timer; ///< Таймер передачи пакета
+
+		NotifyEventBatch m_batch; ///< Накапливаемый пакет уведомлений
+		QSet<long> m_addedIds; ///< Идентификаторы добавленных записей накапливаемого пакета
 
+		int m_eventsCount; ///< Общее количество полученных уведомлений
+		int m_mergedCount; ///< Количество уведомлений, поглощенных при объединении
 	};
-	
-	class ViewFilesTableModel : public DBTableModel<emulation_dal::Emulation_file>
+
+	/**
+	*
+	* \brief Индекс строк модели по идентификаторам записей БД
+	*
+	* Индекс отслеживает сигналы модели: добавление строк в конец, удаление строк и изменение данных строк
+	* учитываются сразу, прочие изменения структуры приводят к перестроению индекса при следующем обращении.
+	* Найденная строка сверяется с записью модели, поэтому прежний индекс записи, замененной в строке, не возвращается.
+	*
+	*/
+	class DBRowIndex : public QObject
 	{
 		Q_OBJECT
 
@@ -448,95 +531,108 @@ namespace Emulation
 		*
 		* \brief Конструктор
 		*
-		* \param parent - указатель на родительский объект
+		* \param model - индексируемая модель, она же родительский объект индекса
 		*
 		*/
-		ViewFilesTableModel(QObject *parent = nullptr);
+		explicit DBRowIndex(QAbstractItemModel *model);
 
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция возвращает номер строки записи с заданным индексом БД или -1 при ее отсутствии в модели
 		*
-		* \param value - список переменных для отображения
-		* \param parent - указатель на родительский объект
+		* \param id - индекс БД
 		*
 		*/
-		ViewFilesTableModel(const emulation_dal::Emulation_file_store &value, QObject *parent = nullptr);
+		int row(const long id) const;
 
-		/// Функция возвращает заголовки столбцов модели
-		QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+		/**
+		*
+		* \brief Функция возвращает признак наличия в модели записи с заданным индексом БД
+		*
+		* \param id - индекс БД
+		*
+		*/
+		bool contains(const long id) const;
 
-		/// Функция возвращает данные, содержащиеся в таблице
-		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	public slots:
+		/// Слот служит для пометки индекса как требующего перестроения
+		void invalidate();
 
-		/// Функция возвращает количество столбцов в модели
-		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	protected:
+		/// Функция возвращает количество записей в модели
+		virtual int recordsCount() const = 0;
 
-	private slots:
-		DB_EVENT_FUNCTIONS(emulation_dal::DB::notifier()->Emulation_file_notify())
+		/// Функция возвращает индекс БД записи в заданной строке модели
+		virtual bool recordId(const int row, long &id) const = 0;
 
-	protected:
-		/// Функция инициализации базовых параметров модели
-		void init();
+	private slots:
+		void insertRows(const QModelIndex &parent, int first, int last);
+		void updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+		void eraseRows(const QModelIndex &parent, int first, int last);
+		void shiftRows(const QModelIndex &parent, int first, int last);
 
-		READONLY_FLAGS_FUNCTION
+	private:
+		/// Функция перестраивает индекс по текущему содержимому модели
+		void rebuild() const;
 
+		mutable QHash<long, int> m_rows; ///< Номера строк записей
+		mutable int m_rowsCount; ///< Количество строк модели, учтенных в индексе
+		mutable bool m_valid; ///< Признак актуальности индекса
 	};
 
 	/**
 	*
-	* \brief Модель для редактирования списка переменных сценария.
+	* \brief Индекс строк модели на основе DBTableModel
 	*
 	*/
-	class EditVariablesTableModel : public DBTableModel<emulation_dal::Emulation_variable>
+	template<class Model>
+	class DBModelRowIndex : public DBRowIndex
 	{
-		Q_OBJECT
-
 	public:
 		/**
 		*
 		* \brief Конструктор
 		*
-		* \param parent - указатель на родительский объект
-		*
-		*/
-		EditVariablesTableModel(QObject *parent = nullptr);
-
-		/**
-		*
-		* \brief Конструктор
-		*
-		* \param value - список переменных для редактирования
-		* \param parent - указатель на родительский объект
+		* \param model - индексируемая модель
 		*
 		*/
-		EditVariablesTableModel(emulation_dal::Emulation_variable_store &value, QObject *parent = nullptr);
+		explicit DBModelRowIndex(Model *model)
+			: DBRowIndex(model), m_model(model)
+		{
+		}
 
-		/// Функция возвращает заголовки столбцов модели
-		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
-
-		/// Функция возвращает данные, содержащиеся в таблице
-		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	protected:
+		virtual int recordsCount() const override
+		{
+			return m_model->size();
+		}
 
-		/// Функция возвращает количество строк в модели
-		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+		virtual bool recordId(const int row, long &id) const override
+		{
+			auto record = m_model->at(row);
 
-		/// Функция возвращает количество столбцов в модели
-		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+			if (record) {
+				id = record->id();
+				return true;
+			}
 
-	protected:
-		/// Функция инициализации базовых параметров модели
-		void init();
+			return false;
+		}
 
-		EDITABLE_FLAGS_FUNCTION
+	private:
+		Model *m_model; ///< Индексируемая модель
 	};
 
 	/**
 	*
-	* \brief Модель для редактирования списка переменных сценария.
+	* \brief Индекс строк модели по нормализованным наименованиям записей
+	*
+	* Используется для проверки уникальности наименований переменных и файлов сценария. Поддерживается
+	* аналогично DBRowIndex: добавление в конец и изменение данных строк учитываются сразу, прочие изменения
+	* структуры модели приводят к перестроению индекса при следующем обращении.
 	*
 	*/
-	class EditFilesTableModel : public DBTableModel<emulation_dal::Emulation_file>
+	class DBNameIndex : public QObject
 	{
 		Q_OBJECT
 
@@ -545,189 +641,937 @@ namespace Emulation
 		*
 		* \brief Конструктор
 		*
-		* \param parent - указатель на родительский объект
+		* \param model - индексируемая модель, она же родительский объект индекса
 		*
 		*/
-		EditFilesTableModel(QObject *parent);
+		explicit DBNameIndex(QAbstractItemModel *model);
+
+		/// Функция возвращает нормализованное наименование, используемое для сравнения
+		static QString normalized(const QString &value);
 
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция возвращает номер строки записи с заданным наименованием или -1 при ее отсутствии в модели
 		*
-		* \param value - список переменных для редактирования
-		* \param parent - указатель на родительский объект
+		* \param name - наименование записи
 		*
 		*/
-		EditFilesTableModel(emulation_dal::Emulation_file_store &value, QObject *parent = nullptr);
+		int row(const QString &name) const;
 
-		/// Функция возвращает заголовки столбцов модели
-		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+		/**
+		*
+		* \brief Функция возвращает признак наличия в модели записи с заданным наименованием
+		*
+		* \param name - наименование записи
+		*
+		*/
+		bool contains(const QString &name) const;
 
-		/// Функция возвращает данные, содержащиеся в таблице
-		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	public slots:
+		/// Слот служит для пометки индекса как требующего перестроения
+		void invalidate();
 
-		/// Функция возвращает количество строк в модели
-		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	protected:
+		/// Функция возвращает количество записей в модели
+		virtual int recordsCount() const = 0;
 
-		/// Функция возвращает количество столбцов в модели
-		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+		/// Функция возвращает наименование записи в заданной строке модели
+		virtual QString recordName(const int row) const = 0;
 
-	protected:
-		/// Функция инициализации базовых параметров модели
-		void init();
+	private slots:
+		void insertRows(const QModelIndex &parent, int first, int last);
+		void updateRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 
-		EDITABLE_FLAGS_FUNCTION
+	private:
+		/// Функция учитывает в индексе наименование записи в заданной строке
+		void insertRow(const int row) const;
+
+		/// Функция перестраивает индекс по текущему содержимому модели
+		void rebuild() const;
+
+		mutable QHash<QString, int> m_rows; ///< Номера строк записей
+		mutable int m_rowsCount; ///< Количество строк модели, учтенных в индексе
+		mutable bool m_valid; ///< Признак актуальности индекса
 	};
 
 	/**
 	*
-	* \brief Виджет просмотра справочника переменных.
+	* \brief Индекс наименований для модели, предоставляющей функцию nameAt
 	*
 	*/
-	class ViewVariablesTableWidget : public DBTableViewBase, public GlobalActions
+	template<class Model>
+	class DBModelNameIndex : public DBNameIndex
 	{
-		Q_OBJECT
-
 	public:
 		/**
 		*
 		* \brief Конструктор
 		*
-		* \param parent - указатель на родительский виджет
+		* \param model - индексируемая модель
 		*
 		*/
-		ViewVariablesTableWidget(QWidget *parent = nullptr);
+		explicit DBModelNameIndex(Model *model)
+			: DBNameIndex(model), m_model(model)
+		{
+		}
 
-		/**
-		*
-		* \brief Конструктор
-		*
-		* \param value - список переменных для редактирования
-		* \param parent - указатель на родительский виджет
-		*
-		*/
-		ViewVariablesTableWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent = nullptr);
+	protected:
+		virtual int recordsCount() const override
+		{
+			return m_model->size();
+		}
+
+		virtual QString recordName(const int row) const override
+		{
+			return m_model->nameAt(row);
+		}
+
+	private:
+		Model *m_model; ///< Индексируемая модель
+	};
+
+	/**
+	*
+	* \brief Класс, служащий для учета изменений записей модели редактирования относительно последнего сохранения
+	*
+	* Добавленными считаются записи, еще не сохраненные в БД (с нулевым индексом), а также записи, добавленные
+	* в транзакции, которая еще не подтверждена: индекс им присваивается сразу при добавлении, и при откате
+	* транзакции они добавляются повторно. Удаленными считаются сохраненные записи, отсутствующие в модели,
+	* измененными - отмеченные функцией markUpdated.
+	*
+	*/
+	template<class Store>
+	class DBChangeTracker
+	{
+	public:
+		typedef typename Store::value_type RecordPtr;
+		typedef typename RecordPtr::element_type Record;
 
 		/**
 		*
-		* \brief Функция для установки данных в модель
+		* \brief Функция служит для установки состояния записей, соответствующего БД
 		*
-		* \param value - массив значений переменных, устанавливаемых для отображения
+		* \param records - записи, сохраненные в БД
 		*
 		*/
-		void setDataVector(const emulation_dal::Emulation_variable_store &value);
+		void reset(const Store &records)
+		{
+			m_savedIds.clear();
+			m_updatedIds.clear();
+			m_persisted.clear();
 
-		MODEL_FUNCTIONS(ViewVariablesTableModel)
+			for (auto record : records) {
+				if (record && record->id())
+					m_savedIds.insert(record->id());
+			}
+		}
 
-	public slots:
-		/// Функция для очистки модели
-		void clearDataVector();
+		/// Функция отмечает сохраненную запись с заданным индексом как измененную
+		void markUpdated(const long id)
+		{
+			if (m_savedIds.contains(id))
+				m_updatedIds.insert(id);
+		}
 
-		TABLE_COLUMN_WIDTH_SETTINGS(ViewVariablesTableWidget);
+		/// Функция отмечает запись, добавленную в БД в еще не подтвержденной транзакции
+		void markPersisted(const RecordPtr &record)
+		{
+			if (record)
+				m_persisted.insert(record.get(), record);
+		}
 
-	protected:
-		/// Функция инициализации базовых параметров виджета
-		void init();
-	};
+		/// Функция возвращает записи, добавленные после последнего сохранения
+		Store inserted(const Store &records) const
+		{
+			Store result;
 
-	class ViewVariablesWidget : public QWidget
-	{
-		Q_OBJECT
+			for (auto record : records) {
+				if (record && (!record->id() || m_persisted.contains(record.get())))
+					result.push_back(record);
+			}
 
-	public:
-		explicit ViewVariablesWidget(QWidget* parent = nullptr);
-		explicit ViewVariablesWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent = nullptr);
+			return result;
+		}
 
-		void tableData(const emulation_dal::Emulation_variable_store &value);
+		/// Функция возвращает сохраненные записи, измененные после последнего сохранения
+		Store updated(const Store &records) const
+		{
+			Store result;
 
-		ViewVariablesTableModel *tableModel() const;
+			for (auto record : records) {
+				if (record && m_updatedIds.contains(record->id()))
+					result.push_back(record);
+			}
 
-		/**
-		*
-		* \brief Функция служит для добавления строки в модель из базы с заданным индексом
-		*
-		* \param id - индекс БД.
-		*
-		*/
-		bool appendById(const long id);
+			return result;
+		}
 
-		/**
-		*
-		* \brief Функция служит для обновления строки в модели с заданным индексом
-		*
-		* \param id - индекс БД.
-		*
-		*/
-		bool updateById(const long id);
+		/// Функция возвращает индексы сохраненных записей, удаленных после последнего сохранения
+		QSet<long> removed(const Store &records) const
+		{
+			QSet<long> result = m_savedIds;
 
-		/**
-		*
-		* \brief Функция служит для удаления строки из модели и БД с заданным индексом
-		*
-		* \param id - индекс БД.
-		*
-		*/
-		bool removeById(const long id);
+			for (auto record : records) {
+				if (record)
+					result.remove(record->id());
+			}
 
-	public slots:
-		void clear();
+			return result;
+		}
 
-	protected:
-		QLabel *m_label;
-		ViewVariablesTableWidget *m_table; ///< Таблица переменных
-		QVBoxLayout *m_layout;
+		/// Функция возвращает признак наличия несохраненных изменений
+		bool hasChanges(const Store &records) const
+		{
+			return !m_updatedIds.isEmpty() || !inserted(records).empty() || !removed(records).isEmpty();
+		}
 
 	private:
-		void init();
-
+		QSet<long> m_savedIds; ///< Индексы записей, сохраненных в БД
+		QSet<long> m_updatedIds; ///< Индексы измененных записей
+		QHash<const Record *, RecordPtr> m_persisted; ///< Записи, добавленные в еще не подтвержденной транзакции
 	};
 
-	class ViewFilesTableWidget : public DBTableViewBase, public GlobalActions
-	{
-		Q_OBJECT
+	template<class Store> class NotifyBatchApplier;
 
+	/**
+	*
+	* \brief Класс, служащий для формирования кратких представлений содержимого переменных и файлов
+	*
+	* Таблицы отображают только размер и начальный фрагмент содержимого, не передавая его целиком через QVariant.
+	*
+	*/
+	class PayloadPreview
+	{
 	public:
+		static const int DefaultLength = 64; ///< Длина фрагмента содержимого по умолчанию
+
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция возвращает начальный фрагмент содержимого, пригодный для отображения в таблице
 		*
-		* \param parent - указатель на родительский виджет
+		* \param value - содержимое
+		* \param length - максимальная длина фрагмента
 		*
 		*/
-		ViewFilesTableWidget(QWidget *parent = nullptr);
+		static QString text(const QByteArray &value, const int length = DefaultLength);
 
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция возвращает фрагмент содержимого, начальная часть которого прочитана из БД отдельно
 		*
-		* \param value - список переменных для редактирования
-		* \param parent - указатель на родительский виджет
+		* \param prefix - начальная часть содержимого
+		* \param size - полный размер содержимого в байтах
+		* \param length - максимальная длина фрагмента
 		*
 		*/
-		ViewFilesTableWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent = nullptr);
+		static QString prefixText(const QByteArray &prefix, const qint64 size, const int length = DefaultLength);
 
 		/**
 		*
-		* \brief Функция для установки данных в модель
+		* \brief Функция возвращает размер содержимого в виде строки
 		*
-		* \param value - массив значений переменных, устанавливаемых для отображения
+		* \param value - размер содержимого в байтах
 		*
 		*/
-		void setDataVector(const emulation_dal::Emulation_file_store &value);
+		static QString size(const qint64 value);
 
-		MODEL_FUNCTIONS(ViewFilesTableModel)
-
-	public slots:
-		/// Функция для очистки модели
+		/**
+		*
+		* \brief Функция возвращает описание содержимого по его размеру и контрольной сумме MD5, вычисленной в БД
+		*
+		* \param size - размер содержимого в байтах
+		* \param md5 - контрольная сумма содержимого в шестнадцатеричном виде или пустая строка, если она не известна
+		*
+		*/
+		static QString toolTip(const qint64 size, const QString &md5);
+
+		/// Функция возвращает признак двоичного (нетекстового) содержимого
+		static bool isBinary(const QByteArray &value);
+	};
+
+	/**
+	*
+	* \brief Кэш справочников типов переменных и файлов сценариев
+	*
+	* Справочники малы и почти не изменяются, поэтому загружаются целиком один раз и далее читаются без обращения
+	* к БД. Уведомления об изменении справочников сбрасывают кэш, он перечитывается при следующем обращении.
+	*
+	*/
+	class EmulationTypesCache : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		/// Функция возвращает единственный экземпляр кэша
+		static EmulationTypesCache *instance();
+
+		/// Функция возвращает тип переменной с заданным идентификатором
+		std::shared_ptr<emulation_dal::Emulation_variable_type> variableType(const long id);
+
+		/// Функция возвращает наименование типа переменной с заданным идентификатором
+		QString variableTypeName(const long id);
+
+		/// Функция возвращает тип файла с заданным идентификатором
+		std::shared_ptr<emulation_dal::Emulation_file_type> fileType(const long id);
+
+		/// Функция возвращает наименование типа файла с заданным идентификатором
+		QString fileTypeName(const long id);
+
+	signals:
+		/// Сигнал испускается при изменении справочника типов переменных
+		void variableTypesChanged();
+
+		/// Сигнал испускается при изменении справочника типов файлов
+		void fileTypesChanged();
+
+	private slots:
+		void invalidateVariableTypes();
+		void invalidateFileTypes();
+
+	private:
+		/// Конструктор
+		explicit EmulationTypesCache(QObject *parent = nullptr);
+
+		/// Функция инициализации базовых параметров кэша
+		void init();
+
+		/// Функция загружает справочник типов переменных, если он еще не загружен
+		void loadVariableTypes();
+
+		/// Функция загружает справочник типов файлов, если он еще не загружен
+		void loadFileTypes();
+
+		QHash<long, std::shared_ptr<emulation_dal::Emulation_variable_type>> m_variableTypes; ///< Типы переменных
+		QHash<long, std::shared_ptr<emulation_dal::Emulation_file_type>> m_fileTypes; ///< Типы файлов
+
+		bool m_variableTypesLoaded; ///< Признак загруженности справочника типов переменных
+		bool m_fileTypesLoaded; ///< Признак загруженности справочника типов файлов
+	};
+
+	/**
+	*
+	* \brief Модель для просмотра списка переменных сценария.
+	*
+	* Модель хранит проекции записей (EmulationVariableRow): содержимое целиком читается из БД только по запросу редактора.
+	*
+	*/
+	class ViewVariablesTableModel : public TableModelBase, public EmulationVariableRowStore
+	{
+		Q_OBJECT
+
+		template<class> friend class NotifyBatchApplier;
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		ViewVariablesTableModel(QObject *parent = nullptr);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список переменных для отображения
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		ViewVariablesTableModel(const emulation_dal::Emulation_variable_store &value, QObject *parent = nullptr);
+
+		/// Функция возвращает заголовки столбцов модели
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+		/// Функция возвращает данные, содержащиеся в таблице
+		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+		/// Функция возвращает количество строк в модели
+		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+		/// Функция возвращает количество столбцов в модели
+		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+		/// Функция устанавливает записи модели, формируя их проекции
+		void setDataVector(const emulation_dal::Emulation_variable_store &value);
+
+		/// Функция устанавливает проекции записей модели
+		void setDataVector(EmulationVariableRowStore value);
+
+		/// Функция очищает модель
+		void clearDataVector();
+
+		/**
+		*
+		* \brief Функция возвращает полную запись переменной в заданной строке, читая ее из БД
+		*
+		* Модель отдает через data() только начальный фрагмент значения, полное значение читается этой функцией
+		* по требованию потребителя.
+		*
+		* \param row - номер строки
+		*
+		*/
+		std::shared_ptr<emulation_dal::Emulation_variable> record(const int row) const;
+
+		/// Функция возвращает объект, объединяющий уведомления БД в пакеты
+		NotifyEventCoalescer *coalescer() const;
+
+		/// Функция возвращает номер строки записи с заданным индексом БД или -1 при ее отсутствии в модели
+		int rowById(const long id) const;
+
+		/// Функция возвращает признак наличия в модели записи с заданным индексом БД
+		bool containsId(const long id) const;
+
+		/// Функция служит для добавления в конец модели записи с заданным индексом
+		bool appendById(const long id);
+
+		/// Функция служит для обновления строки в модели с заданным индексом
+		bool updateById(const long id);
+
+		/// Функция служит для удаления строки из модели с заданным индексом
+		bool removeById(const long id);
+
+		/// Функция служит для добавления записей в конец модели одним диапазоном строк
+		void appendRecords(EmulationVariableRowStore records);
+
+		/// Функция формирует проекции записей, уже прочитанных из БД; контрольная сумма значения не вычисляется
+		static EmulationVariableRowStore rows(const emulation_dal::Emulation_variable_store &value);
+
+	public slots:
+		/// Слот служит для применения пакета уведомлений БД к модели
+		void applyBatch(const NotifyEventBatch &batch);
+
+	private slots:
+		/// Слот обновления столбца типа после изменения справочника типов
+		void updateTypes();
+
+	protected:
+		/// Функция инициализации базовых параметров модели
+		void init();
+
+		READONLY_FLAGS_FUNCTION
+
+		NotifyEventCoalescer *m_coalescer; ///< Объект, объединяющий уведомления БД в пакеты
+		DBRowIndex *m_rowIndex; ///< Индекс строк модели по идентификаторам записей
+	};
+
+	/**
+	*
+	* \brief Модель для просмотра списка файлов сценария.
+	*
+	* Модель хранит проекции записей (EmulationFileRow): содержимое целиком читается из БД только по запросу редактора.
+	*
+	*/
+	class ViewFilesTableModel : public TableModelBase, public EmulationFileRowStore
+	{
+		Q_OBJECT
+
+		template<class> friend class NotifyBatchApplier;
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		ViewFilesTableModel(QObject *parent = nullptr);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список файлов для отображения
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		ViewFilesTableModel(const emulation_dal::Emulation_file_store &value, QObject *parent = nullptr);
+
+		/// Функция возвращает заголовки столбцов модели
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+		/// Функция возвращает данные, содержащиеся в таблице
+		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+		/// Функция возвращает количество строк в модели
+		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+		/// Функция возвращает количество столбцов в модели
+		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+		/// Функция устанавливает записи модели, формируя их проекции
+		void setDataVector(const emulation_dal::Emulation_file_store &value);
+
+		/// Функция устанавливает проекции записей модели
+		void setDataVector(EmulationFileRowStore value);
+
+		/// Функция очищает модель
+		void clearDataVector();
+
+		/**
+		*
+		* \brief Функция возвращает полную запись файла в заданной строке, читая ее из БД
+		*
+		* \param row - номер строки
+		*
+		*/
+		std::shared_ptr<emulation_dal::Emulation_file> record(const int row) const;
+
+		/// Функция возвращает объект, объединяющий уведомления БД в пакеты
+		NotifyEventCoalescer *coalescer() const;
+
+		/// Функция возвращает номер строки записи с заданным индексом БД или -1 при ее отсутствии в модели
+		int rowById(const long id) const;
+
+		/// Функция возвращает признак наличия в модели записи с заданным индексом БД
+		bool containsId(const long id) const;
+
+		/// Функция служит для добавления в конец модели записи с заданным индексом
+		bool appendById(const long id);
+
+		/// Функция служит для обновления строки в модели с заданным индексом
+		bool updateById(const long id);
+
+		/// Функция служит для удаления строки из модели с заданным индексом
+		bool removeById(const long id);
+
+		/// Функция служит для добавления записей в конец модели одним диапазоном строк
+		void appendRecords(EmulationFileRowStore records);
+
+		/// Функция формирует проекции записей, уже прочитанных из БД; контрольная сумма содержимого не вычисляется
+		static EmulationFileRowStore rows(const emulation_dal::Emulation_file_store &value);
+
+		/// Функция возвращает хранилище, в котором находится содержимое файлов, хранимых по ссылке
+		const EmulationFileStore &fileStore() const;
+
+		/**
+		*
+		* \brief Функция служит для установки хранилища содержимого файлов, хранимых по ссылке
+		*
+		* \param value - файловое хранилище сценария
+		*
+		*/
+		void fileStore(const EmulationFileStore &value);
+
+		/// Функция возвращает контрольные суммы объектов хранилища, на которые ссылаются строки модели
+		QStringList storedHashes() const;
+
+		/// Функция возвращает контрольные суммы объектов хранилища, на которые ссылаются строки с first по last
+		QStringList storedHashes(const int first, const int last) const;
+
+	public slots:
+		/// Слот служит для применения пакета уведомлений БД к модели
+		void applyBatch(const NotifyEventBatch &batch);
+
+		/**
+		*
+		* \brief Слот служит для отметки строк, ссылающихся на проверенный объект хранилища
+		*
+		* \param hash - контрольная сумма объекта
+		* \param status - состояние объекта (EmulationFileStoreVerifier::Status)
+		*
+		*/
+		void objectVerified(const QString &hash, int status);
+
+	private slots:
+		/// Слот обновления столбца типа после изменения справочника типов
+		void updateTypes();
+
+	protected:
+		/// Функция инициализации базовых параметров модели
+		void init();
+
+		READONLY_FLAGS_FUNCTION
+
+		/// Функция возвращает отображение объекта хранилища, удерживая его до смены хранилища или данных
+		std::shared_ptr<const EmulationFileMapping> storedObject(const QString &hash) const;
+
+		NotifyEventCoalescer *m_coalescer; ///< Объект, объединяющий уведомления БД в пакеты
+		DBRowIndex *m_rowIndex; ///< Индекс строк модели по идентификаторам записей
+
+		EmulationFileStore m_fileStore; ///< Хранилище содержимого файлов, хранимых по ссылке
+		mutable QHash<QString, std::shared_ptr<const EmulationFileMapping>> m_storedObjects; ///< Отображения объектов хранилища
+		QHash<QString, int> m_objectStatuses; ///< Состояния поврежденных и отсутствующих объектов хранилища
+	};
+
+	/**
+	*
+	* \brief Модель для редактирования списка переменных сценария.
+	*
+	*/
+	class EditVariablesTableModel : public DBTableModel<emulation_dal::Emulation_variable>
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		EditVariablesTableModel(QObject *parent = nullptr);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список переменных для редактирования
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		EditVariablesTableModel(emulation_dal::Emulation_variable_store &value, QObject *parent = nullptr);
+
+		/// Функция возвращает заголовки столбцов модели
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+		/// Функция возвращает данные, содержащиеся в таблице
+		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+		/// Функция возвращает количество строк в модели
+		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+		/// Функция возвращает количество столбцов в модели
+		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+		/// Функция возвращает наименование записи в заданной строке модели
+		QString nameAt(const int row) const;
+
+		/// Функция возвращает номер строки записи с заданным наименованием или -1 при ее отсутствии в модели
+		int rowByName(const QString &name) const;
+
+		/// Функция возвращает признак наличия в модели записи с заданным наименованием
+		bool containsName(const QString &name) const;
+
+		/**
+		*
+		* \brief Функция служит для установки данных в модель
+		*
+		* Установленные данные считаются соответствующими БД.
+		*
+		* \param value - записи, загруженные из БД
+		*
+		*/
+		void setDataVector(const emulation_dal::Emulation_variable_store &value);
+
+		/// Функция для очистки модели
+		void clearDataVector();
+
+		/// Функция отмечает запись в заданной строке как измененную
+		void markUpdated(const int row);
+
+		/// Функция заменяет запись в заданной строке, отмечает ее как измененную и обновляет индексы модели
+		void replace(const int row, const std::shared_ptr<emulation_dal::Emulation_variable> &value);
+
+		/// Функция отмечает запись, добавленную в БД в еще не подтвержденной транзакции сохранения
+		void markPersisted(const std::shared_ptr<emulation_dal::Emulation_variable> &record);
+
+		/// Функция изменяет данные ячейки (в том числе из делегатов столбцов) и отмечает запись как измененную
+		bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+		/// Функция возвращает записи, добавленные после последнего сохранения
+		emulation_dal::Emulation_variable_store insertedRecords() const;
+
+		/// Функция возвращает записи, измененные после последнего сохранения
+		emulation_dal::Emulation_variable_store updatedRecords() const;
+
+		/// Функция возвращает индексы записей, удаленных после последнего сохранения
+		QSet<long> removedIds() const;
+
+		/// Функция возвращает признак наличия несохраненных изменений
+		bool hasChanges() const;
+
+		/// Функция служит для принятия текущего состояния модели как сохраненного в БД
+		void acceptChanges();
+
+	private slots:
+		/// Слот обновления столбца типа после изменения справочника типов
+		void updateTypes();
+
+	protected:
+		/// Функция инициализации базовых параметров модели
+		void init();
+
+		EDITABLE_FLAGS_FUNCTION
+
+		DBNameIndex *m_nameIndex; ///< Индекс строк модели по наименованиям записей
+		DBChangeTracker<emulation_dal::Emulation_variable_store> m_changes; ///< Учет изменений записей относительно последнего сохранения
+	};
+
+	/**
+	*
+	* \brief Модель для редактирования списка переменных сценария.
+	*
+	*/
+	class EditFilesTableModel : public DBTableModel<emulation_dal::Emulation_file>
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		EditFilesTableModel(QObject *parent);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список переменных для редактирования
+		* \param parent - указатель на родительский объект
+		*
+		*/
+		EditFilesTableModel(emulation_dal::Emulation_file_store &value, QObject *parent = nullptr);
+
+		/// Функция возвращает заголовки столбцов модели
+		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+		/// Функция возвращает данные, содержащиеся в таблице
+		virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+		/// Функция возвращает количество строк в модели
+		virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+		/// Функция возвращает количество столбцов в модели
+		virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+		/// Функция возвращает наименование записи в заданной строке модели
+		QString nameAt(const int row) const;
+
+		/// Функция возвращает номер строки записи с заданным наименованием или -1 при ее отсутствии в модели
+		int rowByName(const QString &name) const;
+
+		/// Функция возвращает признак наличия в модели записи с заданным наименованием
+		bool containsName(const QString &name) const;
+
+		/**
+		*
+		* \brief Функция служит для установки данных в модель
+		*
+		* Установленные данные считаются соответствующими БД.
+		*
+		* \param value - записи, загруженные из БД
+		*
+		*/
+		void setDataVector(const emulation_dal::Emulation_file_store &value);
+
+		/// Функция для очистки модели
+		void clearDataVector();
+
+		/// Функция отмечает запись в заданной строке как измененную
+		void markUpdated(const int row);
+
+		/// Функция заменяет запись в заданной строке, отмечает ее как измененную и обновляет индексы модели
+		void replace(const int row, const std::shared_ptr<emulation_dal::Emulation_file> &value);
+
+		/// Функция отмечает запись, добавленную в БД в еще не подтвержденной транзакции сохранения
+		void markPersisted(const std::shared_ptr<emulation_dal::Emulation_file> &record);
+
+		/// Функция изменяет данные ячейки (в том числе из делегатов столбцов) и отмечает запись как измененную
+		bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+		/// Функция возвращает записи, добавленные после последнего сохранения
+		emulation_dal::Emulation_file_store insertedRecords() const;
+
+		/// Функция возвращает записи, измененные после последнего сохранения
+		emulation_dal::Emulation_file_store updatedRecords() const;
+
+		/// Функция возвращает индексы записей, удаленных после последнего сохранения
+		QSet<long> removedIds() const;
+
+		/// Функция возвращает признак наличия несохраненных изменений
+		bool hasChanges() const;
+
+		/// Функция служит для принятия текущего состояния модели как сохраненного в БД
+		void acceptChanges();
+
+		/// Функция задает хранилище, в котором находится содержимое файлов, хранимых по ссылке
+		void fileStore(const EmulationFileStore &value);
+
+	private slots:
+		/// Слот обновления столбца типа после изменения справочника типов
+		void updateTypes();
+
+	protected:
+		/// Функция инициализации базовых параметров модели
+		void init();
+
+		/// Функция возвращает отображение объекта хранилища, запоминая его до смены хранилища
+		std::shared_ptr<const EmulationFileMapping> storedObject(const QString &hash) const;
+
+		EDITABLE_FLAGS_FUNCTION
+
+		DBNameIndex *m_nameIndex; ///< Индекс строк модели по наименованиям записей
+		DBChangeTracker<emulation_dal::Emulation_file_store> m_changes; ///< Учет изменений записей относительно последнего сохранения
+
+		EmulationFileStore m_fileStore; ///< Хранилище содержимого файлов, хранимых по ссылке
+		mutable QHash<QString, std::shared_ptr<const EmulationFileMapping>> m_storedObjects; ///< Отображения объектов хранилища
+	};
+
+	/**
+	*
+	* \brief Виджет просмотра справочника переменных.
+	*
+	*/
+	class ViewVariablesTableWidget : public DBTableViewBase, public GlobalActions
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		ViewVariablesTableWidget(QWidget *parent = nullptr);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список переменных для редактирования
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		ViewVariablesTableWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent = nullptr);
+
+		/**
+		*
+		* \brief Функция для установки данных в модель
+		*
+		* \param value - массив значений переменных, устанавливаемых для отображения
+		*
+		*/
+		void setDataVector(const emulation_dal::Emulation_variable_store &value);
+
+		MODEL_FUNCTIONS(ViewVariablesTableModel)
+
+	public slots:
+		/// Функция для очистки модели
+		void clearDataVector();
+
+		TABLE_COLUMN_WIDTH_SETTINGS(ViewVariablesTableWidget);
+
+	protected:
+		/// Функция инициализации базовых параметров виджета
+		void init();
+	};
+
+	class ViewVariablesWidget : public QWidget
+	{
+		Q_OBJECT
+
+	public:
+		explicit ViewVariablesWidget(QWidget* parent = nullptr);
+		explicit ViewVariablesWidget(const emulation_dal::Emulation_variable_store &value, QWidget *parent = nullptr);
+
+		void tableData(const emulation_dal::Emulation_variable_store &value);
+
+		ViewVariablesTableModel *tableModel() const;
+
+		/**
+		*
+		* \brief Функция служит для добавления строки в модель из базы с заданным индексом
+		*
+		* \param id - индекс БД.
+		*
+		*/
+		bool appendById(const long id);
+
+		/**
+		*
+		* \brief Функция служит для обновления строки в модели с заданным индексом
+		*
+		* \param id - индекс БД.
+		*
+		*/
+		bool updateById(const long id);
+
+		/**
+		*
+		* \brief Функция служит для удаления строки из модели и БД с заданным индексом
+		*
+		* \param id - индекс БД.
+		*
+		*/
+		bool removeById(const long id);
+
+	public slots:
+		void clear();
+
+	protected:
+		QLabel *m_label;
+		ViewVariablesTableWidget *m_table; ///< Таблица переменных
+		QVBoxLayout *m_layout;
+
+	private:
+		void init();
+
+	};
+
+	class ViewFilesTableWidget : public DBTableViewBase, public GlobalActions
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		ViewFilesTableWidget(QWidget *parent = nullptr);
+
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - список переменных для редактирования
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		ViewFilesTableWidget(const emulation_dal::Emulation_file_store &value, QWidget *parent = nullptr);
+
+		/**
+		*
+		* \brief Функция для установки данных в модель
+		*
+		* \param value - массив значений переменных, устанавливаемых для отображения
+		*
+		*/
+		void setDataVector(const emulation_dal::Emulation_file_store &value);
+
+		MODEL_FUNCTIONS(ViewFilesTableModel)
+
+	public slots:
+		/// Функция для очистки модели
 		void clearDataVector();
 
+		/// Функция сохраняет на диск содержимое выбранного файла сценария
+		void saveContent();
+
 		TABLE_COLUMN_WIDTH_SETTINGS(ViewFilesTableWidget);
 
 	protected:
 		/// Функция инициализации базовых параметров виджета
 		void init();
+
+		/// Функция обработки события вызова контекстного меню
+		void contextMenuEvent(QContextMenuEvent *e);
 	};
 
+	class EmulationFileStoreVerifier;
+
 	class ViewFilesWidget : public QWidget
 	{
 		Q_OBJECT
@@ -772,12 +1616,30 @@ namespace Emulation
 	public slots:
 		void clear();
 
+	private slots:
+		/// Слот отображения объема, сэкономленного файловым хранилищем
+		void usageReady();
+
+		/// Слот ставит в очередь проверки объекты хранилища, на которые ссылаются строки таблицы
+		void verifyFileStore();
+
+		/// Слоты ставят в очередь проверки объекты хранилища, на которые ссылаются добавленные и измененные строки
+		void verifyRows(const QModelIndex &parent, int first, int last);
+		void verifyRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+		/// Слот отображения результатов проверки целостности хранилища
+		void updateIntegrityLabel();
+
 	protected:
 		QLabel *m_label;
 		QLabel *m_useFileStoreLabel;
+		QLabel *m_integrityLabel; ///< Сведения о целостности файлового хранилища
 		ViewFilesTableWidget *m_table; ///< Таблица переменных
 		QVBoxLayout *m_layout;
 
+		QFutureWatcher<EmulationFileStore::Usage> *m_usageWatcher; ///< Объект наблюдения за подсчетом использования хранилища
+		EmulationFileStoreVerifier *m_verifier; ///< Объект проверки целостности файлового хранилища
+
 	private:
 		void init();
 
@@ -1019,6 +1881,9 @@ namespace Emulation
 
 		/// Функция обработки события вызова контекстного меню
 		void contextMenuEvent(QContextMenuEvent *e);
+
+		/// Функция возвращает путь к файловому хранилищу, если оно используется сценарием
+		QString fileStorePath() const;
 	};
 
 	class EditFilesWidget : public EditFilesVariablesWidgetBase
@@ -1066,6 +1931,10 @@ namespace Emulation
 
 		void updateFileStoreAccesibility();
 
+	private slots:
+		/// Слот передает модели хранилище, заданное корневым каталогом
+		void updateFileStore();
+
 	protected:
 		CheckBox *m_useFileStoreCheckBox;
 		QLineEdit *m_fileStorePath;
@@ -1095,78 +1964,401 @@ namespace Emulation
 
 		/**
 		*
-		* \brief Функция установки описания
+		* \brief Функция установки описания
+		*
+		* \param value - устанавливаемое значчение
+		*
+		*/
+		void description(const QString& value);
+
+		/// Функция возвращает описание
+		QString description() const;
+
+		/// Функция, служащая для очистки описания
+		void clear();
+
+		void loadDBData();
+		void updateDBData();
+
+	private slots:
+		void update(const NotifyEvent &ev);
+
+	protected:
+		PlainTextEdit *m_descriptionEdit; ///< Виджет редактирования описания
+
+	private:
+		/// Функция инициализации базовых параметров виджета
+		void init();
+
+	};
+
+	/**
+	*
+	* \brief Согласованный снимок данных сценария, прочитанный из БД одной транзакцией
+	*
+	* Каждую часть снимка забирает (перемещает) один получатель: переменные и файлы - ViewDVFSplitter, хосты
+	* топологии - ViewBasicsWidget, первую страницу запросов - EmulationRuntimeRequestsModel.
+	*
+	*/
+	struct EmulationSnapshot
+	{
+		/// Части снимка
+		enum Part
+		{
+			Variables = 0x1, ///< Переменные сценария
+			Files = 0x2, ///< Файлы сценария
+			TopologyHosts = 0x4, ///< Холст и хосты топологии
+			RuntimeRequests = 0x8 ///< Первая страница запросов
+		};
+		Q_DECLARE_FLAGS(Parts, Part)
+
+		long emulationId = 0; ///< Идентификатор сценария
+		Parts requestedParts; ///< Запрошенные части снимка
+		Parts parts; ///< Прочитанные части снимка
+		Parts confirmedParts; ///< Части, копия которых в локальном кэше подтверждена БД и поэтому не читалась
+		QDateTime updateTime; ///< Время изменения сценария, к которому относится снимок
+		QString digest; ///< Контрольная сумма переменных и файлов, вычисленная БД при чтении снимка
+		bool cached = false; ///< Признак снимка, прочитанного из локального кэша
+		QString error; ///< Текст ошибки чтения снимка из БД
+
+		std::shared_ptr<emulation_dal::Emulation> emulation; ///< Запись сценария
+		std::shared_ptr<EmulationVariableRowStore> variables; ///< Проекции переменных сценария
+		std::shared_ptr<EmulationFileRowStore> files; ///< Проекции файлов сценария
+		std::shared_ptr<emulation_dal::Emulation_topology_canvas> canvas; ///< Холст топологии сценария
+		std::shared_ptr<emulation_dal::Emulation_topology_host_store> topologyHosts; ///< Хосты холста топологии, если его счетчики не заполнены
+		std::shared_ptr<emulation_dal::Emulation_runtime_request_store> runtimeRequests; ///< Первая страница запросов
+
+		/**
+		*
+		* \brief Функция читает заданные части снимка сценария одной транзакцией
+		*
+		* \param emulationId - идентификатор сценария
+		* \param requestedParts - читаемые части снимка
+		* \param cancelFlag - признак отмены, проверяемый между запросами
+		* \param cachedDigest - контрольная сумма копии переменных и файлов из локального кэша;
+		* при совпадении с суммой, вычисленной БД, переменные и файлы не читаются
+		* \param countedCanvases - холсты, счетчики хостов которых уже заполнены; их хосты не читаются
+		*
+		*/
+		static std::shared_ptr<EmulationSnapshot> load(const long emulationId, const Parts requestedParts, const std::shared_ptr<QAtomicInt> &cancelFlag,
+			const QString &cachedDigest = QString(), const QSet<long> &countedCanvases = QSet<long>());
+
+		/// Функция возвращает признак ошибки чтения запрошенной части снимка; получатель читает такую часть напрямую
+		bool failed(const Part part) const
+		{
+			return !error.isEmpty() && requestedParts.testFlag(part);
+		}
+
+	private:
+		/// Функция возвращает контрольную сумму переменных и файлов сценария, вычисленную БД
+		static QString digest(odb::database &db, const long emulationId);
+
+		template<class Store>
+		static std::shared_ptr<Store> query(odb::database &db, const odb::query<typename Store::value_type::element_type> &q)
+		{
+			auto result = std::make_shared<Store>();
+
+			odb::result<typename Store::value_type::element_type> rows(db.query<typename Store::value_type::element_type>(q));
+
+			for (auto it = rows.begin(); it != rows.end(); ++it)
+				result->push_back(it.load());
+
+			return result;
+		}
+	};
+
+	Q_DECLARE_OPERATORS_FOR_FLAGS(EmulationSnapshot::Parts)
+
+	/**
+	*
+	* \brief Загрузчик снимков данных сценария, принадлежащий открытому окну сценария
+	*
+	* Запросы частей снимка, поступившие от виджетов окна за один такт цикла обработки событий, объединяются
+	* в одну фоновую загрузку. Готовый снимок передается всем виджетам окна сигналом loaded.
+	*
+	*/
+	class EmulationSnapshotLoader : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Функция создает загрузчик окна сценария, если он еще не создан
+		*
+		* \param container - окно сценария (ViewWidget, EditWidget)
+		*
+		*/
+		static EmulationSnapshotLoader *attach(QObject *container);
+
+		/**
+		*
+		* \brief Функция возвращает загрузчик окна, которому принадлежит объект, или nullptr
+		*
+		* \param object - объект окна сценария или любой из его дочерних объектов
+		*
+		*/
+		static EmulationSnapshotLoader *of(const QObject *object);
+
+		/**
+		*
+		* \brief Функция служит для запроса частей снимка сценария
+		*
+		* \param emulationId - идентификатор сценария
+		* \param parts - запрашиваемые части снимка
+		*
+		*/
+		void load(const long emulationId, const EmulationSnapshot::Parts parts);
+
+		/// Функция возвращает признак выполнения фоновой загрузки
+		bool isLoading() const;
+
+	signals:
+		/// Сигнал испускается по завершении загрузки снимка
+		void loaded(const std::shared_ptr<EmulationSnapshot> &snapshot);
+
+	private slots:
+		void start();
+		void cacheRead();
+		void loadFinished();
+
+	private:
+		/// Конструктор
+		explicit EmulationSnapshotLoader(QObject *container);
+
+		/**
+		*
+		* \brief Функция запускает фоновую загрузку снимка из БД
+		*
+		* \param cachedDigest - контрольная сумма копии переменных и файлов из локального кэша
+		*
+		*/
+		void startLoading(const QString &cachedDigest);
+
+		QFutureWatcher<std::shared_ptr<EmulationSnapshot>> *m_cacheWatcher; ///< Объект наблюдения за чтением снимка из локального кэша
+		QFutureWatcher<std::shared_ptr<EmulationSnapshot>> *m_watcher; ///< Объект наблюдения за фоновой загрузкой
+		QTimer *m_startTimer; ///< Таймер объединения запросов одного такта
+		std::shared_ptr<QAtomicInt> m_cancelFlag; ///< Признак отмены выполняемой загрузки
+
+		long m_loadingId; ///< Идентификатор сценария выполняемой загрузки
+		EmulationSnapshot::Parts m_loadingParts; ///< Части снимка выполняемой загрузки
+		long m_requestedId; ///< Идентификатор сценария, запрошенного до запуска загрузки
+		EmulationSnapshot::Parts m_requestedParts; ///< Запрошенные до запуска загрузки части снимка
+	};
+
+	/**
+	*
+	* \brief Виджет, включающий в себя два виджета: редактирования описания и просмотра списка переменных.
+	*
+	*/
+	class ViewDVFSplitter : public DVFSplitterBase
+	{
+		Q_OBJECT
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		explicit ViewDVFSplitter(WidgetBase* parent);
+
+		/**
+		*
+		* \brief Функция, используемая для установки списка переменных
+		*
+		* \param value - массив, содержащий список переменных
+		*
+		*/
+		void variablesData(const emulation_dal::Emulation_variable_store &value);
+
+		void filesData(const emulation_dal::Emulation_file_store &value);
+
+		/// Функция возвращает модель для отображения списка переменных сценария
+		ViewVariablesTableModel *model() const;
+
+		/// Функция служит для установки возможности редактирования описания
+		void setEditable(const bool flag);
+
+		/**
+		*
+		* \brief Функция служит для загрузки данных сценария
+		*
+		* Описание устанавливается сразу, переменные и файлы запрашиваются у загрузчика снимков окна и добавляются
+		* в модели порциями. Повторный вызов или очистка виджета отменяют незавершенную загрузку.
+		*
+		*/
+		void loadDBData();
+
+		/// Функция возвращает признак выполнения фоновой загрузки
+		bool isLoading() const;
+
+		static const int LoadChunkSize = 500; ///< Количество записей, добавляемых в модель за один такт
+
+	signals:
+		/// Сигнал испускается по завершении загрузки переменных и файлов сценария
+		void loaded();
+
+	public slots:
+		/// Функция для очистки виджетов
+		void clear();
+
+	private slots:
+		// Сохранение настроек
+		SPLITTER_SETTINGS(ViewDVFSplitter)
+
+		void snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot);
+		void loadNextChunk();
+
+		void appendVariable(const NotifyEvent &ev);
+		void updateVariable(const NotifyEvent &ev);
+		void removeVariable(const NotifyEvent &ev);
+
+		void appendFile(const NotifyEvent &ev);
+		void updateFile(const NotifyEvent &ev);
+		void removeFile(const NotifyEvent &ev);
+
+
+	protected:
+		ViewVariablesWidget *m_variablesWidget; ///< Виджет отображения переменных сценария
+		ViewFilesWidget *m_filesWidget; ///< Виджет отображения переменных сценария
+
+	private:
+		/// Функция инициализации базовых параметров виджета
+		void init();
+
+		/// Функция отменяет незавершенную фоновую загрузку
+		void cancelLoading();
+
+		/// Функция читает переменные и файлы напрямую, если снимок сценария прочитать не удалось
+		void loadFailed();
+
+		/// Функции запоминают записи, измененные во время загрузки, и исключают их из еще не добавленных в модель
+		void variableChanged(const long id);
+		void fileChanged(const long id);
+
+		/**
+		*
+		* \brief Функция исключает измененные записи из еще не добавленных в модель и заново читает их из БД
 		*
-		* \param value - устанавливаемое значчение
+		* \param pending - еще не добавленные в модель записи
+		* \param offset - количество уже добавленных записей
+		* \param ids - индексы БД измененных записей
+		* \param model - модель, в которую добавляются прочитанные записи
 		*
 		*/
-		void description(const QString& value);
+		template<class Store, class Model>
+		static void dropChanged(Store &pending, const size_t offset, const QSet<long> &ids, Model *model)
+		{
+			if (ids.isEmpty())
+				return;
 
-		/// Функция возвращает описание
-		QString description() const;
+			pending.erase(std::remove_if(pending.begin() + offset, pending.end(), [&ids, model](const typename Store::value_type &record) {
+				if (!record || !ids.contains(record->id()))
+					return false;
 
-		/// Функция, служащая для очистки описания
-		void clear();
+				// Удаленная запись из БД не читается и в модель не попадает
+				model->coalescer()->append(record->id());
 
-		void loadDBData();
-		void updateDBData();
+				return true;
+			}), pending.end());
+		}
 
-	private slots:
-		void update(const NotifyEvent &ev);
+		QTimer *m_chunkTimer; ///< Таймер порционного заполнения моделей
+		long m_loadingId; ///< Идентификатор сценария, снимок которого ожидается (0 - загрузка не выполняется)
 
-	protected:
-		PlainTextEdit *m_descriptionEdit; ///< Виджет редактирования описания
+		std::shared_ptr<EmulationVariableRowStore> m_pendingVariables; ///< Еще не добавленные в модель переменные
+		std::shared_ptr<EmulationFileRowStore> m_pendingFiles; ///< Еще не добавленные в модель файлы
+		size_t m_variablesOffset; ///< Количество переменных, добавленных в модель
+		size_t m_filesOffset; ///< Количество файлов, добавленных в модель
+		bool m_showingCache; ///< Признак отображения копии из локального кэша, еще не подтвержденной БД
 
-	private:
-		/// Функция инициализации базовых параметров виджета
-		void init();
+		QSet<long> m_changedVariables; ///< Переменные, измененные или удаленные во время загрузки
+		QSet<long> m_changedFiles; ///< Файлы, измененные или удаленные во время загрузки
 
+		friend class EmulationNotifyDispatcher;
 	};
 
 	/**
 	*
-	* \brief Виджет, включающий в себя два виджета: редактирования описания и просмотра списка переменных.
+	* \brief Диспетчер уведомлений БД об изменении сценариев, их переменных и файлов.
+	*
+	* Диспетчер единожды подключается к уведомлениям Emulation_variable_notify и Emulation_file_notify и доставляет
+	* событие только тем виджетам ViewDVFSplitter, которые отображают сценарий - владелец записи. Принадлежность
+	* записей, загруженных в виджеты, запоминается, поэтому события чужих сценариев не требуют обращения к БД.
+	*
+	* Уведомления Emulation_notify ретранслируются сигналом emulationUpdated; запись сценария читается из БД
+	* не более одного раза на событие и разделяется всеми получателями.
 	*
 	*/
-	class ViewDVFSplitter : public DVFSplitterBase
+	class EmulationNotifyDispatcher : public QObject
 	{
 		Q_OBJECT
+
 	public:
+		/// Функция возвращает единственный экземпляр диспетчера
+		static EmulationNotifyDispatcher *instance();
+
 		/**
 		*
-		* \brief Конструктор
+		* \brief Функция служит для подписки виджета на уведомления, относящиеся к сценарию
 		*
-		* \param parent - указатель на родительский виджет
+		* \param splitter - подписываемый виджет
+		* \param emulationId - идентификатор сценария, отображаемого виджетом
 		*
 		*/
-		explicit ViewDVFSplitter(WidgetBase* parent);
+		void subscribe(ViewDVFSplitter *splitter, const long emulationId);
 
 		/**
 		*
-		* \brief Функция, используемая для установки списка переменных
+		* \brief Функция служит для отмены подписки виджета
 		*
-		* \param value - массив, содержащий список переменных
+		* \param splitter - виджет, подписка которого отменяется
 		*
 		*/
-		void variablesData(const emulation_dal::Emulation_variable_store &value);
+		void unsubscribe(ViewDVFSplitter *splitter);
 
-		void filesData(const emulation_dal::Emulation_file_store &value);
+		/**
+		*
+		* \brief Функция запоминает принадлежность загруженных переменных сценарию
+		*
+		* \param value - список переменных сценария
+		* \param emulationId - идентификатор сценария
+		*
+		*/
+		void registerVariables(const EmulationVariableRowStore &value, const long emulationId);
 
-		/// Функция возвращает модель для отображения списка переменных сценария
-		ViewVariablesTableModel *model() const;
+		/**
+		*
+		* \brief Функция запоминает принадлежность загруженных файлов сценарию
+		*
+		* \param value - список файлов сценария
+		* \param emulationId - идентификатор сценария
+		*
+		*/
+		void registerFiles(const EmulationFileRowStore &value, const long emulationId);
 
-		/// Функция служит для установки возможности редактирования описания
-		void setEditable(const bool flag);
+		/**
+		*
+		* \brief Функция возвращает запись сценария, к которому относится обрабатываемое уведомление
+		*
+		* В течение доставки сигнала emulationUpdated запись читается из БД только при первом вызове.
+		*
+		* \param ev - описание события
+		*
+		*/
+		std::shared_ptr<emulation_dal::Emulation> emulation(const NotifyEvent &ev);
 
-		void loadDBData();
+		/// Функция возвращает количество запросов к БД, сэкономленных за счет разделения записи сценария
+		int savedQueriesCount() const;
 
-	public slots:
-		/// Функция для очистки виджетов
-		void clear();
+	signals:
+		/// Сигнал испускается при получении уведомления об изменении сценария
+		void emulationUpdated(const NotifyEvent &ev);
 
 	private slots:
-		// Сохранение настроек
-		SPLITTER_SETTINGS(ViewDVFSplitter)
+		void updateEmulation(const NotifyEvent &ev);
 
 		void appendVariable(const NotifyEvent &ev);
 		void updateVariable(const NotifyEvent &ev);
@@ -1176,15 +2368,33 @@ namespace Emulation
 		void updateFile(const NotifyEvent &ev);
 		void removeFile(const NotifyEvent &ev);
 
-
-	protected:
-		ViewVariablesWidget *m_variablesWidget; ///< Виджет отображения переменных сценария
-		ViewFilesWidget *m_filesWidget; ///< Виджет отображения переменных сценария
+		void splitterDestroyed(QObject *object);
 
 	private:
-		/// Функция инициализации базовых параметров виджета
+		/// Конструктор
+		explicit EmulationNotifyDispatcher(QObject *parent = nullptr);
+
+		/// Функция инициализации базовых параметров диспетчера
 		void init();
 
+		/// Функция удаляет сведения о принадлежности записей сценарию, который больше никем не отображается
+		void releaseOwners(const long emulationId);
+
+		/// Функция возвращает виджеты, которым доставляется изменение записи с заданным индексом
+		QList<ViewDVFSplitter *> recipients(const QHash<long, long> &owners, const long id) const;
+
+		QMultiHash<long, ViewDVFSplitter *> m_subscribers; ///< Виджеты, подписанные на сценарии
+		QHash<ViewDVFSplitter *, long> m_subscriptions; ///< Сценарии, отображаемые подписанными виджетами
+
+		QHash<long, long> m_variableOwners; ///< Сценарии - владельцы отображаемых переменных
+		QHash<long, long> m_fileOwners; ///< Сценарии - владельцы отображаемых файлов
+
+		bool m_emulationDispatching; ///< Признак доставки уведомления об изменении сценария
+		bool m_emulationFetched; ///< Признак того, что запись сценария для текущего уведомления уже прочитана
+		long m_emulationId; ///< Идентификатор сценария текущего уведомления
+		std::shared_ptr<emulation_dal::Emulation> m_emulation; ///< Запись сценария текущего уведомления
+
+		int m_savedQueriesCount; ///< Количество сэкономленных запросов к БД
 	};
 
 	/**
@@ -1205,6 +2415,8 @@ namespace Emulation
 		*/
 		explicit EditDVFSplitter(WidgetBase *parent);
 
+		~EditDVFSplitter();
+
 		/**
 		*
 		* \brief Функция, используемая для установки списка переменных
@@ -1245,6 +2457,136 @@ namespace Emulation
 		/// Функция инициализации базовых параметров виджета
 		void init();
 
+		/**
+		*
+		* \brief Функция записывает в текущей транзакции только добавленные, измененные и удаленные переменные и файлы
+		*
+		* Ошибки БД не перехватываются, чтобы транзакция сохранения сценария была отменена целиком. Отметки изменений
+		* снимаются и связи сценария обновляются только после подтверждения транзакции.
+		*
+		* \param data - сохраняемый сценарий
+		*
+		*/
+		void saveChanges(const std::shared_ptr<emulation_dal::Emulation> &data);
+
+		/// Функция, вызываемая ODB при завершении транзакции, в которой записаны изменения
+		static void changesSaved(unsigned short event, void *key, unsigned long long);
+
+		/// Функция помещает содержимое файлов, хранимых в файловом хранилище, в хранилище и заменяет его ссылками
+		void storeFilePayloads();
+
+		bool m_fullSavePending; ///< Признак записи переменных и файлов через связи сценария вне транзакции, подтверждение которой не известно
+
+	};
+
+	/**
+	*
+	* \brief Условия отбора и порядок сортировки запросов сценария, выполняемые на стороне БД
+	*
+	*/
+	struct RuntimeRequestsFilter
+	{
+		/// Поле, по которому упорядочиваются запросы
+		enum SortField
+		{
+			SortById, ///< По идентификатору (порядку создания)
+			SortByCreationTime ///< По времени создания
+		};
+
+		QList<int> states; ///< Допустимые состояния запроса (пустой список - любое состояние)
+		QDateTime fromTime; ///< Нижняя граница времени создания (недействительное значение - без ограничения)
+		QDateTime toTime; ///< Верхняя граница времени создания (недействительное значение - без ограничения)
+		QString user; ///< Фрагмент имени пользователя, запустившего запрос
+
+		SortField sortField = SortById; ///< Поле сортировки
+		Qt::SortOrder sortOrder = Qt::DescendingOrder; ///< Направление сортировки
+
+		/// Функция возвращает признак отсутствия условий отбора
+		bool isEmpty() const;
+
+		/// Функция возвращает признак порядка от новых запросов к старым
+		bool isNewestFirst() const;
+
+		/// Функция возвращает признак отбора и сортировки по умолчанию (все запросы от новых к старым)
+		bool isDefault() const;
+	};
+
+	/**
+	*
+	* \brief Виджет формы задания условий отбора запросов сценария
+	*
+	*/
+	class RuntimeRequestsFilterForm : public DialogFormBase
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		RuntimeRequestsFilterForm(QWidget *parent = nullptr);
+
+		/// Функция возвращает заданные в форме условия отбора
+		RuntimeRequestsFilter filter() const;
+
+		/**
+		*
+		* \brief Функция служит для отображения условий отбора в форме
+		*
+		* \param value - условия отбора
+		*
+		*/
+		void filter(const RuntimeRequestsFilter &value);
+
+	private slots:
+		void updateAccesibility();
+
+	protected:
+		/// Функция инициализации базовых параметров формы
+		void init();
+
+		QLineEdit *m_statesLine; ///< Виджет для ввода списка кодов состояний через запятую
+		CheckBox *m_fromCheck; ///< Флаг использования нижней границы времени создания
+		QDateTimeEdit *m_fromEdit; ///< Виджет для ввода нижней границы времени создания
+		CheckBox *m_toCheck; ///< Флаг использования верхней границы времени создания
+		QDateTimeEdit *m_toEdit; ///< Виджет для ввода верхней границы времени создания
+		QLineEdit *m_userLine; ///< Виджет для ввода имени пользователя
+		QComboBox *m_sortFieldCombo; ///< Выпадающий список для выбора поля сортировки
+		QComboBox *m_sortOrderCombo; ///< Выпадающий список для выбора направления сортировки
+	};
+
+	/**
+	*
+	* \brief Виджет диалога задания условий отбора запросов сценария
+	*
+	*/
+	class RuntimeRequestsFilterDialog : public DialogBase
+	{
+		Q_OBJECT
+
+	public:
+		/**
+		*
+		* \brief Конструктор
+		*
+		* \param value - текущие условия отбора
+		* \param parent - указатель на родительский виджет
+		*
+		*/
+		RuntimeRequestsFilterDialog(const RuntimeRequestsFilter &value, QWidget *parent = nullptr);
+
+		/// Функция возвращает заданные пользователем условия отбора
+		RuntimeRequestsFilter filter() const;
+
+		RuntimeRequestsFilterForm *form() const;
+
+	private:
+		/// Функция инициализации базовых параметров формы
+		void init();
 	};
 
 	/**
@@ -1256,6 +2598,8 @@ namespace Emulation
 	{
 		Q_OBJECT
 
+		template<class> friend class NotifyBatchApplier;
+
 	public:
 		/**
 		*
@@ -1276,9 +2620,64 @@ namespace Emulation
 		*/
 		void loadDBData();
 
+		/// Функция возвращает признак наличия в БД еще не загруженных (более старых) запросов
+		virtual bool canFetchMore(const QModelIndex &parent) const override;
+
+		/// Функция служит для загрузки следующей страницы более старых запросов
+		virtual void fetchMore(const QModelIndex &parent) override;
+
+		static const int PageSize = 256; ///< Количество запросов, загружаемых за одно обращение к БД
+
+		/// Функция служит для очистки модели и сброса постраничной загрузки
+		void clearDataVector();
+
+		/// Функция возвращает текущие условия отбора и сортировки запросов
+		const RuntimeRequestsFilter &filter() const;
+
+		/**
+		*
+		* \brief Функция служит для установки условий отбора и сортировки с перезагрузкой первой страницы
+		*
+		* \param value - условия отбора и сортировки
+		*
+		*/
+		void setFilter(const RuntimeRequestsFilter &value);
+
+		/**
+		*
+		* \brief Функция формирует запрос страницы запросов сценария с учетом условий отбора и сортировки
+		*
+		* \param emulationId - идентификатор сценария
+		* \param filter - условия отбора и сортировки
+		* \param lastId - идентификатор последнего загруженного запроса (0 - первая страница)
+		* \param lastTime - время создания последнего загруженного запроса
+		*
+		*/
+		static odb::query<emulation_dal::Emulation_runtime_request> pageQuery(const long emulationId, const RuntimeRequestsFilter &filter,
+			const long lastId, const QDateTime &lastTime);
+
 		/// Функция возвращает сценарий, которому принадлежат отображаемые запросы
 		const std::shared_ptr<emulation_dal::Emulation> emulation() const;
 
+		/// Функция возвращает объект, объединяющий уведомления БД в пакеты
+		NotifyEventCoalescer *coalescer() const;
+
+		/// Функция возвращает номер строки записи с заданным индексом БД или -1 при ее отсутствии в модели
+		int rowById(const long id) const;
+
+		/// Функция возвращает признак наличия в модели записи с заданным индексом БД
+		bool containsId(const long id) const;
+
+		/// Функция служит для обновления строки в модели с заданным индексом
+		bool updateById(const long id);
+
+		/// Функция служит для удаления строки из модели с заданным индексом
+		bool removeById(const long id);
+
+	public slots:
+		/// Слот служит для применения пакета уведомлений БД к модели
+		void applyBatch(const NotifyEventBatch &batch);
+
 	private slots:
 		/**
 		*
@@ -1307,6 +2706,9 @@ namespace Emulation
 		*/
 		void remove(const NotifyEvent &ev);
 
+		/// Слот получения первой страницы запросов из снимка сценария
+		void snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot);
+
 	protected:
 
 		/// Функция для создания сингально-слотовых соединений, используемых для обновления состояния модели на основании уведомлений от БД
@@ -1314,6 +2716,36 @@ namespace Emulation
 
 		/// Функция инициализации базовых параметров модели
 		void init();
+
+		/**
+		*
+		* \brief Функция служит для чтения следующей страницы запросов сценария с учетом условий отбора и сортировки
+		*
+		* \param emulationId - идентификатор сценария
+		*
+		*/
+		std::shared_ptr<emulation_dal::Emulation_runtime_request_store> queryPage(const long emulationId) const;
+
+		/// Функция формирует условие запроса к БД по идентификатору сценария и условиям отбора
+		static odb::query<emulation_dal::Emulation_runtime_request> filterQuery(const long emulationId, const RuntimeRequestsFilter &filter);
+
+		/// Функция проверяет на стороне БД соответствие запроса с заданным идентификатором условиям отбора
+		bool matchesFilter(const long id) const;
+
+		/// Функция запоминает границу загруженных данных по прочитанной странице
+		void setPageBounds(const emulation_dal::Emulation_runtime_request_store &page);
+
+		/// Функция сбрасывает границу загруженных данных
+		void resetPageBounds();
+
+		NotifyEventCoalescer *m_coalescer; ///< Объект, объединяющий уведомления БД в пакеты
+		DBRowIndex *m_rowIndex; ///< Индекс строк модели по идентификаторам записей
+
+		RuntimeRequestsFilter m_filter; ///< Условия отбора и сортировки запросов
+		long m_lastId; ///< Идентификатор последнего загруженного запроса (0 - ничего не загружено)
+		QDateTime m_lastTime; ///< Время создания последнего загруженного запроса
+		bool m_hasMore; ///< Признак наличия в БД еще не загруженных запросов
+		long m_snapshotId; ///< Идентификатор сценария, первая страница запросов которого ожидается из снимка
 	};
 
 	/**
@@ -1384,6 +2816,9 @@ namespace Emulation
 		/// Функция, служащая для запроса остановки текущего сценария
 		void stopCurrentScenery();
 
+		/// Слот, вызываемый глобальным объектом-действием поиска findAction
+		virtual void onFindAction();
+
 		private slots:
 		TABLE_COLUMN_WIDTH_SETTINGS(RuntimeRequestsWidget)
 
@@ -1481,6 +2916,106 @@ namespace Emulation
 
 	};
 
+	/**
+	*
+	* \brief Счетчик хостов топологий сценариев в разрезе типов хостов
+	*
+	* Счетчики холста заполняются однократно при первом обращении и далее поддерживаются по уведомлениям
+	* Emulation_topology_host_notify, поэтому получение количества хостов не требует обращения к БД.
+	*
+	*/
+	class TopologyHostsCounter : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		/// Функция возвращает единственный экземпляр счетчика
+		static TopologyHostsCounter *instance();
+
+		/**
+		*
+		* \brief Функция служит для заполнения счетчиков холста, если они еще не заполнены
+		*
+		* \param canvas - холст топологии сценария
+		*
+		*/
+		void load(const std::shared_ptr<emulation_dal::Emulation_topology_canvas> &canvas);
+
+		/**
+		*
+		* \brief Функция служит для заполнения счетчиков холста по прочитанным хостам, заменяя прежние значения
+		*
+		* \param canvas - холст топологии сценария
+		* \param hosts - хосты холста
+		*
+		*/
+		void load(const std::shared_ptr<emulation_dal::Emulation_topology_canvas> &canvas, const emulation_dal::Emulation_topology_host_store &hosts);
+
+		/**
+		*
+		* \brief Функция возвращает количество хостов заданного типа на холсте
+		*
+		* \param canvasId - идентификатор холста
+		* \param hostTypeId - идентификатор типа хоста
+		*
+		*/
+		int count(const long canvasId, const long hostTypeId) const;
+
+		/**
+		*
+		* \brief Функция возвращает количество виртуальных машин на холсте
+		*
+		* \param canvasId - идентификатор холста
+		*
+		*/
+		int virtualHostsCount(const long canvasId) const;
+
+		/// Функция возвращает признак заполненности счетчиков холста
+		bool isLoaded(const long canvasId) const;
+
+		/// Функция возвращает идентификаторы холстов с заполненными счетчиками
+		QSet<long> loadedCanvases() const;
+
+		/// Функция отмечает холст как отображаемый виджетом: счетчики такого холста поддерживаются по уведомлениям
+		void attach(const long canvasId);
+
+		/// Функция снимает отметку; счетчики холста, который больше никем не отображается, сбрасываются
+		void detach(const long canvasId);
+
+	signals:
+		/// Сигнал испускается при изменении количества хостов на холсте
+		void countChanged(const long canvasId);
+
+	private slots:
+		void appendHost(const NotifyEvent &ev);
+		void updateHost(const NotifyEvent &ev);
+		void removeHost(const NotifyEvent &ev);
+
+	private:
+		/// Конструктор
+		explicit TopologyHostsCounter(QObject *parent = nullptr);
+
+		/// Функция инициализации базовых параметров счетчика
+		void init();
+
+		/// Функция учитывает хост в счетчиках холста
+		void insertHost(const long canvasId, const std::shared_ptr<emulation_dal::Emulation_topology_host> &host);
+
+		/// Функция исключает хост из счетчиков и возвращает идентификатор его холста или 0, если хост не учтен
+		long eraseHost(const long hostId);
+
+		/// Функция сбрасывает счетчики холста
+		void reset(const long canvasId);
+
+		/// Функция возвращает признак того, что тип хоста соответствует виртуальной машине
+		bool isVirtualHostType(const long hostTypeId, const std::shared_ptr<emulation_dal::Emulation_topology_host> &host);
+
+		QHash<long, QHash<long, int>> m_counts; ///< Количество хостов холстов в разрезе типов
+		QHash<long, QPair<long, long>> m_hosts; ///< Холст и тип учтенных хостов
+		QHash<long, bool> m_virtualHostTypes; ///< Признаки соответствия типов хостов виртуальной машине
+		QHash<long, int> m_viewers; ///< Количество виджетов, отображающих холсты
+	};
+
 	/**
 	*
 	* \brief Виджет, служащий для просмотра основных параметров проекта эмуляционного моделирования
@@ -1500,6 +3035,9 @@ namespace Emulation
 		*/
 		ViewBasicsWidget(ViewWidget *viewWidget);
 
+		/// Деструктор
+		~ViewBasicsWidget();
+
 		/**
 		*
 		* \brief Функция задает количество хостов, используемое для отображения пользователю
@@ -1531,13 +3069,20 @@ namespace Emulation
 
 	private slots:
 		void updateHostsCount();
+		void updateHostsCount(const long canvasId);
+		void snapshotLoaded(const std::shared_ptr<EmulationSnapshot> &snapshot);
 
 	protected:
 		/// Функция инициализации базовых параметров виджета
 		void init();
 
+		/// Функция задает отображаемый холст топологии и отмечает его в счетчике хостов
+		void canvasId(const long value);
+
 		QLabel *m_hostsCountValueLabel; ///< Виджет, служащий для отображения количества хостов в проекте
 
+		long m_canvasId; ///< Идентификатор холста топологии сценария
+
 		ViewDVFSplitter *m_dvfWidget; ///< Комбинированный виджет для отображения описания и переменных
 	};
 